@@ -0,0 +1,185 @@
+// Headless batch driver: lexes and parses source files without the GUI.
+//
+//   FrontendBatch [--tokens] [--lalr] [-j N] FILE...
+//
+// Prints one ACCEPTED/REJECTED line per file (with the position of the
+// offending token) and, with --tokens, the token table before it. The
+// statements are parsed by the LL(1) PDA, or with --lalr by the LALR(1)
+// parser for the full grammar. Files
+// are analyzed in parallel (-j, default: all cores) but always reported
+// in command-line order.
+// Exit status: 0 all accepted, 1 some rejected, 2 a file could not be read.
+
+#include "LalrParser.h"
+#include "Lexer.h"
+#include "MappedFile.h"
+#include "PdaParser.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Files with more tokens than this fan out into sub-tasks
+const std::size_t kSplitTokens = 1 << 16;
+
+struct Options {
+    bool dumpTokens = false;
+    bool lalr = false;
+    unsigned jobs = 0; // 0 = one per hardware thread
+    std::vector<std::string> files;
+};
+
+enum class Outcome { Accepted, Rejected, Failed };
+
+void formatTokens(const TokenStream& tokens, std::size_t first, std::size_t last, std::string& out)
+{
+    for (std::size_t i = first; i < last; ++i) {
+        const Token& tok = tokens[i];
+        out += std::to_string(tok.line) + ':' + std::to_string(tok.column) + '\t';
+        out += tokenKindName(tok.kind);
+        out += '\t';
+        out += tokens.text(tok);
+        out += '\n';
+    }
+}
+
+PdaParser::Result parseTokens(const TokenStream& tokens, const Options& options)
+{
+    return options.lalr ? LalrParser::parse(tokens) : PdaParser::validate(tokens);
+}
+
+// Lexes and parses one file into out. With a pool, large files are lexed
+// in chunks and run the parse and the token dump as parallel sub-tasks.
+Outcome analyzeFile(const std::string& path, const Options& options, ThreadPool* pool, std::string& out)
+{
+    std::string error;
+    std::shared_ptr<const MappedFile> file = MappedFile::open(path, &error);
+    if (!file) {
+        out += error + "\n";
+        return Outcome::Failed;
+    }
+
+    const TokenStream tokens = pool ? Lexer::tokenize(file, file->data(), *pool, &error)
+                                    : Lexer::tokenize(file, file->data(), &error);
+    if (!error.empty()) {
+        out += path + ": " + error + "\n";
+        return Outcome::Failed;
+    }
+    PdaParser::Result result;
+
+    if (pool && tokens.size() >= kSplitTokens) {
+        const std::size_t chunks = options.dumpTokens ? (tokens.size() + kSplitTokens - 1) / kSplitTokens : 0;
+        std::vector<std::string> parts(chunks);
+
+        TaskGroup group(*pool);
+        group.run([&]() { result = parseTokens(tokens, options); });
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c]() {
+                formatTokens(tokens, c * kSplitTokens, std::min(tokens.size(), (c + 1) * kSplitTokens), parts[c]);
+            });
+        }
+        group.wait();
+
+        for (const std::string& part : parts) out += part;
+    } else {
+        if (options.dumpTokens) formatTokens(tokens, 0, tokens.size(), out);
+        result = parseTokens(tokens, options);
+    }
+
+    out += path;
+    if (result.accepted) {
+        out += ": ACCEPTED";
+    } else if (result.position < static_cast<int>(tokens.size())) {
+        const Token& tok = tokens[result.position];
+        out += ": REJECTED at " + std::to_string(tok.line) + ':' + std::to_string(tok.column);
+        out += " near '";
+        out += tokens.text(tok);
+        out += '\'';
+    } else {
+        out += ": REJECTED at end of input";
+    }
+    out += " (" + std::to_string(tokens.size()) + " tokens)\n";
+    return result.accepted ? Outcome::Accepted : Outcome::Rejected;
+}
+
+struct FileJob {
+    std::string out;
+    Outcome outcome = Outcome::Failed;
+    std::atomic<bool> done{false};
+};
+
+void printUsage()
+{
+    std::fprintf(stderr, "usage: FrontendBatch [--tokens] [--lalr] [-j N] FILE...\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tokens") == 0) {
+            options.dumpTokens = true;
+        } else if (std::strcmp(argv[i], "--lalr") == 0) {
+            options.lalr = true;
+        } else if ((std::strcmp(argv[i], "-j") == 0 || std::strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+            options.jobs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strncmp(argv[i], "-j", 2) == 0 && argv[i][2] != '\0') {
+            options.jobs = static_cast<unsigned>(std::strtoul(argv[i] + 2, nullptr, 10));
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage();
+            return 0;
+        } else {
+            options.files.push_back(argv[i]);
+        }
+    }
+    if (options.files.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    const std::size_t count = options.files.size();
+    std::unique_ptr<FileJob[]> jobs(new FileJob[count]);
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.jobs != 1) {
+        pool = std::make_unique<ThreadPool>(options.jobs);
+        for (std::size_t i = 0; i < count; ++i) {
+            pool->submit([&, i]() {
+                jobs[i].outcome = analyzeFile(options.files[i], options, pool.get(), jobs[i].out);
+                jobs[i].done.store(true, std::memory_order_release);
+            });
+        }
+    }
+
+    // Report in input order; the main thread helps with queued work while
+    // the next file in line is still running.
+    int status = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        FileJob& job = jobs[i];
+        if (pool) {
+            while (!job.done.load(std::memory_order_acquire)) {
+                if (!pool->runPendingTask()) std::this_thread::yield();
+            }
+        } else {
+            job.outcome = analyzeFile(options.files[i], options, nullptr, job.out);
+        }
+
+        if (job.outcome == Outcome::Failed) std::fflush(stdout);
+        std::fwrite(job.out.data(), 1, job.out.size(), job.outcome == Outcome::Failed ? stderr : stdout);
+        std::string().swap(job.out);
+
+        if (job.outcome == Outcome::Failed) status = 2;
+        else if (job.outcome == Outcome::Rejected && status == 0) status = 1;
+    }
+    return status;
+}
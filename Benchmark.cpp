@@ -0,0 +1,276 @@
+// Automaton benchmark: compiles regexes with Thompson's construction, subset
+// construction and Hopcroft minimization, and reports sizes and timings.
+//
+//   FrontendBench [PATTERN...]
+//
+// Without arguments a built-in suite is used. Patterns use the Thompson
+// tab's syntax (see RegexParser.h). Further tables run the lazy DFA on
+// (a|b)*a(a|b)^n, whose full DFA is exponential in n, compare subset
+// construction with Brzozowski derivatives, bit-parallel matching with the
+// minimized DFA and dense with packed DFA tables, time the Pike VM
+// against std::regex backtracking on (a|a)*b, and time the PDA's parse,
+// its allocation-free validation and its recorded trace. Parsing 10000-
+// symbol patterns into regex terms is checked against a time and term
+// budget; the exit status is 1 if it is exceeded.
+
+#include "BitParallel.h"
+#include "Brzozowski.h"
+#include "Dfa.h"
+#include "Lexer.h"
+#include "PdaParser.h"
+#include "PdaTrace.h"
+#include "PikeVm.h"
+#include "RegexParser.h"
+#include "Thompson.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Case {
+    std::string name;
+    NFA nfa;
+    std::string pattern; // same language in regex syntax
+};
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// (a|b)* a (a|b)^n: the subset construction needs 2^(n+1) states
+NFA nthFromLast(int n)
+{
+    Thompson t;
+    auto ab = [&] { return t.unionOf(t.symbol('a'), t.symbol('b')); };
+    Fragment f = t.concat(t.closure(ab()), t.symbol('a'));
+    for (int i = 0; i < n; ++i) f = t.concat(f, ab());
+    return t.finish(f);
+}
+
+// [A-Za-z_][A-Za-z0-9_]*, as drawn in the Lexical Analysis tab
+NFA identifier()
+{
+    const std::string letters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+    Thompson t;
+    return t.finish(t.concat(t.anyOf(letters), t.closure(t.anyOf(letters + "0123456789"))));
+}
+
+double mibPerSecond(std::size_t bytes, double ms)
+{
+    return bytes / (1024.0 * 1024.0) / (ms / 1000.0);
+}
+
+std::vector<Case> builtinSuite()
+{
+    std::vector<Case> suite;
+    auto regex = [&](const std::string& pattern) { suite.push_back({pattern, Thompson::fromRegex(pattern, nullptr), pattern}); };
+
+    regex("a|b");
+    regex("a*b|c");
+    regex("ab*c*d|ef*");
+    regex("if|elif|else|for|while|def|return");
+    regex("a*a*a*a*a*a*a*a*b");
+    regex("abc|abd|abe|abf|abg|abh");
+    for (int n : {4, 8, 12}) {
+        std::string pattern = "(a|b)*a";
+        for (int i = 0; i < n; ++i) pattern += "(a|b)";
+        suite.push_back({"(a|b)*a(a|b)^" + std::to_string(n), nthFromLast(n), pattern});
+    }
+    return suite;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<Case> cases;
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) cases.push_back({argv[i], Thompson::fromRegex(argv[i], nullptr), argv[i]});
+    } else {
+        cases = builtinSuite();
+    }
+
+    std::printf("%-36s %8s %8s %8s %10s %10s %10s\n",
+                "pattern", "NFA", "DFA", "minDFA", "subset ms", "hopcroft ms", "table KiB");
+    for (const auto& c : cases) {
+        auto start = std::chrono::steady_clock::now();
+        DFA dfa = SubsetConstruction::determinize(c.nfa);
+        double subsetMs = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        DFA minimal = Hopcroft::minimize(dfa);
+        double hopcroftMs = millisecondsSince(start);
+
+        auto kib = [](const DFA& d) { return d.next.size() * sizeof(d.next[0]) / 1024.0; };
+        std::printf("%-36s %8d %8d %8d %10.3f %10.3f %4.0f -> %.0f\n",
+                    c.name.c_str(), c.nfa.stateCount(), dfa.stateCount, minimal.stateCount,
+                    subsetMs, hopcroftMs, kib(dfa), kib(minimal));
+    }
+
+    // Derivatives build the DFA straight from the pattern, parse included
+    std::printf("\n%-36s %10s %10s %10s %10s\n", "pattern", "subset ms", "DFA", "deriv ms", "DFA");
+    for (const auto& c : cases) {
+        auto start = std::chrono::steady_clock::now();
+        DFA dfa = SubsetConstruction::determinize(Thompson::fromRegex(c.pattern, nullptr));
+        double subsetMs = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        DFA derivative = Brzozowski::fromRegex(c.pattern);
+        double derivativeMs = millisecondsSince(start);
+        std::printf("%-36s %10.3f %10d %10.3f %10d\n", c.name.c_str(),
+                    subsetMs, dfa.stateCount, derivativeMs, derivative.stateCount);
+    }
+    if (argc > 1) return 0;
+
+    // Long literal patterns must parse in linear time and terms; a parse
+    // over budget fails the run
+    int status = 0;
+    std::printf("\nRegex terms for 10000-symbol patterns (budget: %d ms, 3 terms per symbol)\n", 1000);
+    std::printf("%-36s %10s %10s\n", "pattern", "parse ms", "terms");
+    std::mt19937 letters(11);
+    std::string randomLiteral, periodic;
+    for (int k = 0; k < 10000; ++k) {
+        randomLiteral += static_cast<char>('a' + letters() % 26);
+        periodic += "abcde"[k % 5];
+    }
+    for (const auto& [name, pattern] : {std::make_pair("random literal", randomLiteral),
+                                        std::make_pair("periodic literal", periodic),
+                                        std::make_pair("grouped literal", "(" + randomLiteral + ")x")}) {
+        RegexTerms terms;
+        auto start = std::chrono::steady_clock::now();
+        RegexParser<RegexTerms>(terms).parse(pattern);
+        const double ms = millisecondsSince(start);
+        const bool over = ms > 1000 || terms.size() > 3 * pattern.size();
+        std::printf("%-36s %10.1f %10zu%s\n", name, ms, terms.size(), over ? " OVER BUDGET" : "");
+        if (over) status = 1;
+    }
+
+    // Random a/b input: nearly every byte reaches a new subset for large n
+    std::string input(1 << 20, 'a');
+    std::mt19937 rng(42);
+    for (char& c : input) c = (rng() & 1) ? 'a' : 'b';
+
+    std::printf("\nLazy DFA, 1 MiB random a/b input, cache of 1024 states\n");
+    std::printf("%-36s %10s %10s %10s\n", "pattern", "MiB/s", "cached", "flushes");
+    for (int n : {4, 8, 12, 16, 20}) {
+        LazyDFA lazy(nthFromLast(n), 1024);
+        auto start = std::chrono::steady_clock::now();
+        lazy.matches(input);
+        double ms = millisecondsSince(start);
+        std::printf("%-36s %10.1f %10zu %10zu\n", ("(a|b)*a(a|b)^" + std::to_string(n)).c_str(),
+                    1000.0 / ms, lazy.cachedStates(), lazy.flushCount());
+    }
+
+    // Whole-input matches over 16 MiB, so neither engine can stop early
+    const std::size_t size = 16 << 20;
+    std::string ab(size, 'a'), word(size, 'x'), text(size, 'x');
+    for (char& c : ab) c = (rng() & 1) ? 'a' : 'b';
+    const char alnum[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+    for (std::size_t i = 1; i < size; ++i) word[i] = alnum[rng() % 63];
+    for (char& c : text) c = 'a' + rng() % 26;
+
+    std::printf("\nBit-parallel vs minimized DFA, 16 MiB input\n");
+    std::printf("%-36s %10s %10s %10s\n", "pattern", "positions", "bits MiB/s", "DFA MiB/s");
+    auto compare = [&](const std::string& name, const NFA& nfa, const std::string& in) {
+        auto bits = BitParallelMatcher::compile(nfa);
+        auto start = std::chrono::steady_clock::now();
+        bool a = bits->matches(in);
+        double bitsMs = millisecondsSince(start);
+
+        // The subset construction gives up where the DFA would be exponential
+        DFA minimal = Hopcroft::minimize(SubsetConstruction::determinize(nfa, 1 << 16));
+        std::string dfaRate = "-";
+        if (minimal.stateCount > 0) {
+            start = std::chrono::steady_clock::now();
+            bool b = minimal.matches(in);
+            dfaRate = std::to_string(static_cast<int>(mibPerSecond(in.size(), millisecondsSince(start))));
+            if (a != b) dfaRate += " MISMATCH";
+        }
+        std::printf("%-36s %10d %10.0f %10s\n", name.c_str(), bits->positionCount(),
+                    mibPerSecond(in.size(), bitsMs), dfaRate.c_str());
+    };
+    compare("[A-Za-z_][A-Za-z0-9_]* (Shift-And)", identifier(), word);
+    compare("(a|b)*a(a|b)^8", nthFromLast(8), ab);
+    compare("(a|b)*a(a|b)^40", nthFromLast(40), ab);
+
+    auto needle = BitParallelMatcher::compile(Thompson::fromRegex("needle|haystack"));
+    auto start = std::chrono::steady_clock::now();
+    bool found = needle->search(text) != std::string_view::npos;
+    std::printf("%-36s %10d %10.0f %10s\n", found ? "search needle|haystack (found)" : "search needle|haystack",
+                needle->positionCount(), mibPerSecond(text.size(), millisecondsSince(start)), "-");
+
+    std::printf("\nDense vs packed (byte classes + row displacement) minimized DFA, 16 MiB input\n");
+    std::printf("%-36s %8s %8s %10s %10s %10s %10s\n",
+                "pattern", "states", "classes", "dense KiB", "packed KiB", "dense MiB/s", "packed MiB/s");
+    auto pack = [&](const std::string& name, const NFA& nfa, const std::string& in) {
+        DFA minimal = Hopcroft::minimize(SubsetConstruction::determinize(nfa));
+        PackedDFA packed(minimal);
+        auto start = std::chrono::steady_clock::now();
+        bool a = minimal.matches(in);
+        double denseMs = millisecondsSince(start);
+        start = std::chrono::steady_clock::now();
+        bool b = packed.matches(in);
+        double packedMs = millisecondsSince(start);
+        std::printf("%-36s %8d %8d %10.1f %10.1f %10.0f %10.0f%s\n", name.c_str(), minimal.stateCount,
+                    packed.classCount(), minimal.next.size() * sizeof(minimal.next[0]) / 1024.0,
+                    packed.tableBytes() / 1024.0, mibPerSecond(in.size(), denseMs),
+                    mibPerSecond(in.size(), packedMs), a != b ? " MISMATCH" : "");
+    };
+    pack("[A-Za-z_][A-Za-z0-9_]*", identifier(), word);
+    pack("(a|b)*a(a|b)^8", nthFromLast(8), ab);
+    pack("(a|b)*a(a|b)^12", nthFromLast(12), ab);
+
+    // a^n never matches, and a backtracker tries all 2^n ways to split it
+    std::printf("\nPike VM vs std::regex backtracking, (a|a)*b on a^n\n");
+    std::printf("%-36s %10s %10s\n", "input", "Pike ms", "regex ms");
+    const NFA pathological = Thompson::fromRegex("(a|a)*b");
+    const std::regex backtracking("(a|a)*b");
+    for (int n : {12, 16, 20, 22}) {
+        const std::string as(n, 'a');
+        start = std::chrono::steady_clock::now();
+        bool a = PikeVM::matchWhole(pathological, as).found;
+        double pikeMs = millisecondsSince(start);
+        start = std::chrono::steady_clock::now();
+        bool b = std::regex_match(as, backtracking);
+        double regexMs = millisecondsSince(start);
+        std::printf("%-36s %10.3f %10.3f%s\n", ("a^" + std::to_string(n)).c_str(), pikeMs, regexMs,
+                    a != b ? " MISMATCH" : "");
+    }
+
+    start = std::chrono::steady_clock::now();
+    RegexMatch m = PikeVM::search(Thompson::fromRegex("(a|b)*c"), std::string_view(ab).substr(0, 1 << 20));
+    std::printf("%-36s %10.1f %10s\n", m.found ? "search (a|b)*c, 1 MiB (found)" : "search (a|b)*c, 1 MiB",
+                millisecondsSince(start), "-");
+
+    std::string program;
+    while (program.size() < (8u << 20)) program += "total = (total + price * 3) // 2 - rate % 7\n";
+    const TokenStream tokens = Lexer::tokenize(program);
+    std::printf("\nPDA parse vs validate, %zu tokens\n", tokens.size());
+    std::printf("%-36s %10s %10s\n", "mode", "ms", "accepted");
+    start = std::chrono::steady_clock::now();
+    PdaParser::Result parsed = PdaParser::parse(tokens);
+    std::printf("%-36s %10.1f %10s\n", "parse", millisecondsSince(start), parsed.accepted ? "yes" : "no");
+    start = std::chrono::steady_clock::now();
+    parsed = PdaParser::validate(tokens);
+    std::printf("%-36s %10.1f %10s\n", "validate", millisecondsSince(start), parsed.accepted ? "yes" : "no");
+
+    PdaTrace trace;
+    start = std::chrono::steady_clock::now();
+    parsed = PdaParser::parse(tokens, &trace);
+    std::printf("%-36s %10.1f %10s\n", "parse, traced", millisecondsSince(start), parsed.accepted ? "yes" : "no");
+    std::printf("%-36s %10zu %10.1f\n", "trace steps, MiB", trace.stepCount(), trace.bytes() / 1048576.0);
+
+    // Jumping to a step rebuilds its stack from the persistent record
+    std::mt19937 steps(7);
+    std::size_t formatted = 0;
+    start = std::chrono::steady_clock::now();
+    for (int k = 0; k < 10000; ++k) formatted += trace.line(steps() % trace.stepCount()).size();
+    std::printf("%-36s %10.1f %10s\n", "10000 random trace lines", millisecondsSince(start), formatted ? "-" : "");
+    return status;
+}
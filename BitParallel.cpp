@@ -0,0 +1,197 @@
+#include "BitParallel.h"
+
+#include <map>
+
+template <int W>
+struct BitParallelMatcher::Bits {
+    std::uint64_t w[W];
+
+    static Bits load(const std::uint64_t* p)
+    {
+        Bits b;
+        for (int i = 0; i < W; ++i) b.w[i] = p[i];
+        return b;
+    }
+    static Bits load(const std::array<std::uint64_t, 2>& a) { return load(a.data()); }
+
+    bool any() const
+    {
+        std::uint64_t x = 0;
+        for (int i = 0; i < W; ++i) x |= w[i];
+        return x != 0;
+    }
+    Bits operator&(const Bits& o) const { Bits r; for (int i = 0; i < W; ++i) r.w[i] = w[i] & o.w[i]; return r; }
+    Bits operator|(const Bits& o) const { Bits r; for (int i = 0; i < W; ++i) r.w[i] = w[i] | o.w[i]; return r; }
+    Bits shiftedLeft() const
+    {
+        Bits r;
+        std::uint64_t carry = 0;
+        for (int i = 0; i < W; ++i) {
+            r.w[i] = (w[i] << 1) | carry;
+            carry = w[i] >> 63;
+        }
+        return r;
+    }
+};
+
+namespace {
+
+void setBit(std::uint64_t* set, int bit) { set[bit >> 6] |= std::uint64_t(1) << (bit & 63); }
+bool testBit(const std::uint64_t* set, int bit) { return (set[bit >> 6] >> (bit & 63)) & 1; }
+
+} // namespace
+
+// ==========================
+//   BitParallelMatcher IMPLEMENTATION
+// ==========================
+
+std::shared_ptr<const BitParallelMatcher> BitParallelMatcher::compile(const NFA& nfa)
+{
+    const int n = nfa.stateCount();
+    if (n == 0) return nullptr;
+
+    // Positions: symbol edges grouped by (from, to), each with its byte set
+    struct Position {
+        int from;
+        int to;
+        std::array<std::uint64_t, 4> bytes;
+    };
+    std::vector<Position> positionList;
+    std::vector<std::vector<int>> startingAt(n); // positions leaving each state
+    for (int s = 0; s < n; ++s) {
+        std::map<int, int> byTarget;
+        for (const auto& e : nfa.out(s)) {
+            if (e.epsilon) continue;
+            auto it = byTarget.find(e.to);
+            if (it == byTarget.end()) {
+                if (static_cast<int>(positionList.size()) == kMaxPositions) return nullptr;
+                it = byTarget.emplace(e.to, static_cast<int>(positionList.size())).first;
+                positionList.push_back({s, e.to, {}});
+                startingAt[s].push_back(it->second);
+            }
+            positionList[it->second].bytes[e.symbol >> 6] |= std::uint64_t(1) << (e.symbol & 63);
+        }
+    }
+
+    std::shared_ptr<BitParallelMatcher> m(new BitParallelMatcher());
+    m->positions = static_cast<int>(positionList.size());
+    const int bits = m->positions + 1;
+    m->words = bits <= 64 ? 1 : 2;
+    m->chunks = (bits + 7) / 8;
+    const int W = m->words;
+
+    // Follow set of each bit: positions leaving the ε-closure of its target
+    std::vector<std::array<std::uint64_t, 2>> followOf(bits);
+    std::vector<int> mark(n, -1), work;
+    auto closeFrom = [&](int state, int bit) {
+        work.assign(1, state);
+        mark[state] = bit;
+        while (!work.empty()) {
+            int s = work.back();
+            work.pop_back();
+            if (nfa.isAccept(s)) setBit(m->last.data(), bit);
+            for (int p : startingAt[s]) setBit(followOf[bit].data(), p + 1);
+            for (const auto& e : nfa.out(s)) {
+                if (!e.epsilon || mark[e.to] == bit) continue;
+                mark[e.to] = bit;
+                work.push_back(e.to);
+            }
+        }
+    };
+    closeFrom(nfa.startState, 0);
+    for (int p = 0; p < m->positions; ++p) closeFrom(positionList[p].to, p + 1);
+
+    m->byteMask.assign(256 * W, 0);
+    for (int p = 0; p < m->positions; ++p)
+        for (int c = 0; c < 256; ++c)
+            if ((positionList[p].bytes[c >> 6] >> (c & 63)) & 1) setBit(&m->byteMask[c * W], p + 1);
+
+    // Shift-And applies when bit i is only followed by i and i + 1
+    m->shiftAnd = true;
+    for (int i = 0; i < bits && m->shiftAnd; ++i) {
+        for (int j = 0; j < bits; ++j) {
+            if (!testBit(followOf[i].data(), j)) continue;
+            if (j == i) setBit(m->loop.data(), j);
+            else if (j == i + 1) setBit(m->next.data(), j);
+            else { m->shiftAnd = false; break; }
+        }
+    }
+
+    // Follow tables: entry [k][v] is the union of follow sets of the bits
+    // set in v, read as bits 8k .. 8k + 7 of the active set
+    m->follow.assign(static_cast<std::size_t>(m->chunks) * 256 * W, 0);
+    for (int k = 0; k < m->chunks; ++k) {
+        std::uint64_t* table = &m->follow[static_cast<std::size_t>(k) * 256 * W];
+        for (int v = 1; v < 256; ++v) {
+            int low = v & -v;
+            int bit = 8 * k;
+            while ((low >> (bit - 8 * k)) != 1) ++bit;
+            const std::uint64_t* rest = &table[(v ^ low) * W];
+            for (int i = 0; i < W; ++i)
+                table[v * W + i] = rest[i] | (bit < bits ? followOf[bit][i] : 0);
+        }
+    }
+    return m;
+}
+
+template <int W, bool ShiftAnd>
+BitParallelMatcher::Bits<W> BitParallelMatcher::followWords(const Bits<W>& d) const
+{
+    using Set = Bits<W>;
+    if (ShiftAnd) return (d.shiftedLeft() & Set::load(next)) | (d & Set::load(loop));
+
+    Set f{};
+    for (int k = 0; k < chunks; ++k) {
+        unsigned v = static_cast<unsigned>(d.w[k >> 3] >> ((k & 7) * 8)) & 0xFF;
+        f = f | Set::load(&follow[(static_cast<std::size_t>(k) * 256 + v) * W]);
+    }
+    return f;
+}
+
+template <int W, bool ShiftAnd>
+bool BitParallelMatcher::matchesWords(std::string_view input) const
+{
+    using Set = Bits<W>;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(input.data());
+    const std::size_t n = input.size();
+
+    Set d{};
+    d.w[0] = 1; // initial state
+    // An empty set stays empty, so only look for it once per block
+    const std::size_t kBlock = 32;
+    for (std::size_t i = 0; i < n; i += kBlock) {
+        const std::size_t end = i + kBlock < n ? i + kBlock : n;
+        for (std::size_t j = i; j < end; ++j)
+            d = followWords<W, ShiftAnd>(d) & Set::load(&byteMask[bytes[j] * W]);
+        if (!d.any()) return false;
+    }
+    return (d & Set::load(last)).any();
+}
+
+template <int W, bool ShiftAnd>
+std::size_t BitParallelMatcher::searchWords(std::string_view input) const
+{
+    using Set = Bits<W>;
+    const Set accept = Set::load(last);
+    if (last[0] & 1) return 0; // matches the empty string
+
+    Set d{};
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        d.w[0] |= 1; // a match may start anywhere
+        d = followWords<W, ShiftAnd>(d) & Set::load(&byteMask[static_cast<unsigned char>(input[i]) * W]);
+        if ((d & accept).any()) return i + 1;
+    }
+    return std::string_view::npos;
+}
+
+bool BitParallelMatcher::matches(std::string_view input) const
+{
+    if (words == 1) return shiftAnd ? matchesWords<1, true>(input) : matchesWords<1, false>(input);
+    return shiftAnd ? matchesWords<2, true>(input) : matchesWords<2, false>(input);
+}
+
+std::size_t BitParallelMatcher::search(std::string_view input) const
+{
+    if (words == 1) return shiftAnd ? searchWords<1, true>(input) : searchWords<1, false>(input);
+    return shiftAnd ? searchWords<2, true>(input) : searchWords<2, false>(input);
+}
@@ -0,0 +1,63 @@
+#ifndef BITPARALLEL_H
+#define BITPARALLEL_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Nfa.h"
+
+// ===============
+// BitParallelMatcher
+// ===============
+// Bit-parallel simulation of the Glushkov (position) automaton of an NFA.
+// A position is a group of symbol edges u -> v (a byte set); bit 0 is the
+// initial state and bit p + 1 is position p, so an active set fits in one
+// or two 64-bit words and each input byte costs a few word operations:
+//
+//     D' = Follow(D) & ByteMask[c]
+//
+// Follow(D) is a table lookup per 8 bits of D, or (D << 1) & next | D & loop
+// (Shift-And) when every position is only followed by itself or the next
+// one, as in concatenations of classes and starred classes.
+class BitParallelMatcher
+{
+public:
+    static constexpr int kMaxPositions = 127;
+
+    // Returns nullptr if the NFA has more than kMaxPositions positions.
+    static std::shared_ptr<const BitParallelMatcher> compile(const NFA& nfa);
+
+    // Whole-string match
+    bool matches(std::string_view input) const;
+
+    // End offset of the first match anywhere in input (the shortest one
+    // ending there), or npos
+    std::size_t search(std::string_view input) const;
+
+    int positionCount() const { return positions; }
+    bool isShiftAnd() const { return shiftAnd; }
+
+private:
+    BitParallelMatcher() = default;
+
+    template <int W> struct Bits; // active set of W words
+    template <int W, bool ShiftAnd> Bits<W> followWords(const Bits<W>& d) const;
+    template <int W, bool ShiftAnd> bool matchesWords(std::string_view input) const;
+    template <int W, bool ShiftAnd> std::size_t searchWords(std::string_view input) const;
+
+    int positions = 0;
+    int words = 1;  // 64-bit words per set
+    int chunks = 1; // 8-bit slices of a set, one Follow table each
+    bool shiftAnd = false;
+
+    std::vector<std::uint64_t> byteMask; // [256][words]
+    std::vector<std::uint64_t> follow;   // [chunks][256][words]
+    std::array<std::uint64_t, 2> last{};  // positions (or initial) that accept
+    std::array<std::uint64_t, 2> next{};  // Shift-And: bit i set if i follows i - 1
+    std::array<std::uint64_t, 2> loop{};  // Shift-And: bit i set if i follows itself
+};
+
+#endif // BITPARALLEL_H
@@ -0,0 +1,313 @@
+#include "Brzozowski.h"
+
+#include <algorithm>
+
+#include "Nfa.h"
+#include "RegexParser.h"
+
+// ==========================
+//   RegexTerms IMPLEMENTATION
+// ==========================
+
+namespace {
+
+bool contains(const RegexTerms::ByteSet& set, unsigned char c)
+{
+    return (set[c >> 6] >> (c & 63)) & 1;
+}
+
+} // namespace
+
+std::size_t RegexTerms::NodeHash::operator()(const Node& node) const
+{
+    std::size_t h = static_cast<std::size_t>(node.kind);
+    for (std::uint64_t word : node.set) h = h * 1000003u ^ static_cast<std::size_t>(word ^ (word >> 32));
+    for (Term child : node.children) h = h * 1000003u ^ static_cast<std::size_t>(child);
+    return h;
+}
+
+RegexTerms::RegexTerms()
+{
+    intern({Kind::Empty, false, {}, {}});
+    intern({Kind::Epsilon, true, {}, {}});
+}
+
+RegexTerms::Term RegexTerms::intern(Node&& node)
+{
+    auto [it, inserted] = ids.try_emplace(std::move(node), static_cast<Term>(nodes.size()));
+    if (inserted) nodes.push_back(&it->first);
+    return it->second;
+}
+
+RegexTerms::Term RegexTerms::symbol(unsigned char symbol)
+{
+    ByteSet set{};
+    set[symbol >> 6] |= std::uint64_t(1) << (symbol & 63);
+    return bytes(set);
+}
+
+RegexTerms::Term RegexTerms::bytes(const ByteSet& set)
+{
+    if (set == ByteSet{}) return Empty;
+    return intern({Kind::Bytes, false, set, {}});
+}
+
+RegexTerms::Term RegexTerms::anyOf(std::string_view bytes)
+{
+    ByteSet set{};
+    for (char c : bytes) {
+        unsigned char b = static_cast<unsigned char>(c);
+        set[b >> 6] |= std::uint64_t(1) << (b & 63);
+    }
+    return this->bytes(set);
+}
+
+// r | s: flattened, byte sets merged, ∅ dropped, ε dropped when another
+// alternative is nullable anyway, and the rest sorted by ID
+RegexTerms::Term RegexTerms::unionOf(Term r, Term s)
+{
+    std::vector<Term> alternatives;
+    ByteSet merged{};
+    bool hasBytes = false;
+    for (Term t : {r, s}) {
+        const Node& n = node(t);
+        const std::vector<Term> single{t};
+        for (Term a : n.kind == Kind::Union ? n.children : single) {
+            const Node& alternative = node(a);
+            if (alternative.kind == Kind::Empty) continue;
+            if (alternative.kind == Kind::Bytes) {
+                for (int w = 0; w < 4; ++w) merged[w] |= alternative.set[w];
+                hasBytes = true;
+            } else {
+                alternatives.push_back(a);
+            }
+        }
+    }
+    if (hasBytes) alternatives.push_back(bytes(merged));
+    std::sort(alternatives.begin(), alternatives.end());
+    alternatives.erase(std::unique(alternatives.begin(), alternatives.end()), alternatives.end());
+
+    bool nullableAlternative = std::any_of(alternatives.begin(), alternatives.end(),
+                                           [&](Term a) { return a != Epsilon && nullable(a); });
+    if (nullableAlternative) alternatives.erase(std::remove(alternatives.begin(), alternatives.end(), Epsilon),
+                                                alternatives.end());
+
+    if (alternatives.empty()) return Empty;
+    if (alternatives.size() == 1) return alternatives[0];
+    bool anyNullable = std::any_of(alternatives.begin(), alternatives.end(), [&](Term a) { return nullable(a); });
+    return intern({Kind::Union, anyNullable, {}, std::move(alternatives)});
+}
+
+// r s: ∅ and ε absorbed, (r s) t rewritten to r (s t)
+RegexTerms::Term RegexTerms::concat(Term r, Term s)
+{
+    if (r == Empty || s == Empty) return Empty;
+    if (r == Epsilon) return s;
+    if (s == Epsilon) return r;
+    const Node& n = node(r);
+    if (n.kind == Kind::Concat) return concat(n.children[0], concat(n.children[1], s));
+    return intern({Kind::Concat, nullable(r) && nullable(s), {}, {r, s}});
+}
+
+// r*: ∅* = ε* = ε, r** = r*, (ε | r)* = r*
+RegexTerms::Term RegexTerms::closure(Term r)
+{
+    if (r == Empty || r == Epsilon) return Epsilon;
+    const Node& n = node(r);
+    if (n.kind == Kind::Star) return r;
+    if (n.kind == Kind::Union && n.children[0] == Epsilon) {
+        Term rest = Empty;
+        for (std::size_t i = 1; i < n.children.size(); ++i) rest = unionOf(rest, n.children[i]);
+        return closure(rest);
+    }
+    return intern({Kind::Star, true, {}, {r}});
+}
+
+RegexTerms::Term RegexTerms::derivative(Term r, unsigned char c)
+{
+    const std::uint64_t key = static_cast<std::uint64_t>(r) << 8 | c;
+    auto it = derivatives.find(key);
+    if (it != derivatives.end()) return it->second;
+
+    const Node& n = node(r);
+    Term d = Empty;
+    switch (n.kind) {
+    case Kind::Empty:
+    case Kind::Epsilon:
+        break;
+    case Kind::Bytes:
+        d = contains(n.set, c) ? Epsilon : Empty;
+        break;
+    case Kind::Concat:
+        d = concat(derivative(n.children[0], c), n.children[1]);
+        if (nullable(n.children[0])) d = unionOf(d, derivative(n.children[1], c));
+        break;
+    case Kind::Union:
+        for (Term a : n.children) d = unionOf(d, derivative(a, c));
+        break;
+    case Kind::Star:
+        d = concat(derivative(n.children[0], c), r);
+        break;
+    }
+    derivatives.emplace(key, d);
+    return d;
+}
+
+std::array<std::uint8_t, 256> RegexTerms::byteClasses(Term r, int* classCount) const
+{
+    std::array<std::uint8_t, 256> classes{};
+    int count = 1;
+
+    std::vector<std::uint8_t> seen(nodes.size(), 0);
+    std::vector<Term> work{r};
+    seen[r] = 1;
+    while (!work.empty()) {
+        const Node& n = node(work.back());
+        work.pop_back();
+        for (Term child : n.children) {
+            if (!seen[child]) {
+                seen[child] = 1;
+                work.push_back(child);
+            }
+        }
+        if (n.kind != Kind::Bytes) continue;
+
+        // Split every class into its bytes inside and outside the set
+        std::array<int, 512> renumber;
+        renumber.fill(-1);
+        count = 0;
+        for (int b = 0; b < 256; ++b) {
+            int& id = renumber[classes[b] * 2 + contains(n.set, static_cast<unsigned char>(b))];
+            if (id == -1) id = count++;
+            classes[b] = static_cast<std::uint8_t>(id);
+        }
+    }
+    if (classCount) *classCount = count;
+    return classes;
+}
+
+std::string RegexTerms::toString(Term r) const
+{
+    std::string out;
+    write(r, out);
+    return out;
+}
+
+// Appends r to out, so printing a term is linear in its length
+void RegexTerms::write(Term r, std::string& out) const
+{
+    // Precedence: union 0, concatenation 1, closure 2, atoms 3
+    auto precedence = [&](Term t) {
+        switch (node(t).kind) {
+        case Kind::Union: return 0;
+        case Kind::Concat: return 1;
+        case Kind::Star: return 2;
+        default: return 3;
+        }
+    };
+    auto inner = [&](Term t, int minimum) {
+        const bool parens = precedence(t) < minimum;
+        if (parens) out += '(';
+        write(t, out);
+        if (parens) out += ')';
+    };
+
+    const Node& n = node(r);
+    switch (n.kind) {
+    case Kind::Empty:
+        out += "∅";
+        break;
+    case Kind::Epsilon:
+        out += kEpsilon;
+        break;
+    case Kind::Bytes: {
+        int words = 0, word = 0;
+        for (int w = 0; w < 4; ++w) {
+            if (n.set[w]) {
+                ++words;
+                word = w;
+            }
+        }
+        const std::uint64_t bits = n.set[word];
+        if (words == 1 && (bits & (bits - 1)) == 0) { // one byte, the common case
+            int b = word * 64;
+            while (!((bits >> (b & 63)) & 1)) ++b;
+            out += edgeLabel({0, static_cast<unsigned char>(b), false});
+            break;
+        }
+        std::vector<unsigned char> members;
+        for (int b = 0; b < 256; ++b)
+            if (contains(n.set, static_cast<unsigned char>(b))) members.push_back(static_cast<unsigned char>(b));
+        out += "[" + byteSetLabel(std::move(members)) + "]";
+        break;
+    }
+    case Kind::Concat: {
+        // Concatenations nest to the right; walk the chain instead of recursing
+        Term t = r;
+        for (; node(t).kind == Kind::Concat; t = node(t).children[1]) inner(node(t).children[0], 1);
+        inner(t, 1);
+        break;
+    }
+    case Kind::Union:
+        for (std::size_t i = 0; i < n.children.size(); ++i) {
+            if (i) out += '|';
+            inner(n.children[i], 1);
+        }
+        break;
+    case Kind::Star:
+        inner(n.children[0], 3);
+        out += '*';
+        break;
+    }
+}
+
+// ==========================
+//   Brzozowski IMPLEMENTATION
+// ==========================
+
+DFA Brzozowski::fromRegex(const std::string& regex, int stateLimit, int termLimit, std::vector<std::string>* terms)
+{
+    RegexTerms t;
+    const RegexTerms::Term root = regex.empty() ? t.epsilon() : RegexParser<RegexTerms>(t).parse(regex);
+    auto overBudget = [&]() { return termLimit > 0 && t.size() > static_cast<std::size_t>(termLimit); };
+    if (overBudget()) return DFA();
+
+    // One derivative per byte class; the first byte of a class stands for it
+    int classCount = 0;
+    const auto classes = t.byteClasses(root, &classCount);
+    std::vector<unsigned char> representative(classCount);
+    for (int b = 255; b >= 0; --b) representative[classes[b]] = static_cast<unsigned char>(b);
+
+    DFA dfa;
+    std::unordered_map<RegexTerms::Term, int> ids;
+    std::vector<RegexTerms::Term> states;
+    auto intern = [&](RegexTerms::Term term) {
+        auto [it, inserted] = ids.try_emplace(term, static_cast<int>(states.size()));
+        if (inserted) {
+            states.push_back(term);
+            dfa.next.resize(dfa.next.size() + 256, DFA::Dead);
+            dfa.accepting.push_back(t.nullable(term) ? 1 : 0);
+        }
+        return it->second;
+    };
+
+    dfa.startState = intern(root);
+    std::vector<std::int32_t> targets(classCount);
+    for (std::size_t d = 0; d < states.size(); ++d) {
+        for (int k = 0; k < classCount; ++k) {
+            RegexTerms::Term next = t.derivative(states[d], representative[k]);
+            targets[k] = next == RegexTerms::Empty ? DFA::Dead : intern(next);
+        }
+        if (stateLimit > 0 && states.size() > static_cast<std::size_t>(stateLimit)) return DFA();
+        if (overBudget()) return DFA();
+        std::int32_t* row = &dfa.next[d * 256];
+        for (int b = 0; b < 256; ++b) row[b] = targets[classes[b]];
+    }
+    dfa.stateCount = static_cast<int>(states.size());
+
+    if (terms) {
+        terms->clear();
+        for (RegexTerms::Term term : states) terms->push_back(t.toString(term));
+    }
+    return dfa;
+}
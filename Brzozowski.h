@@ -0,0 +1,105 @@
+#ifndef BRZOZOWSKI_H
+#define BRZOZOWSKI_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Dfa.h"
+
+// ===============
+// RegexTerms
+// ===============
+// Hash-consed regex terms: every term is interned once and named by a
+// small integer, so structurally equal terms are the same ID. The smart
+// constructors normalize as they intern (unions are flattened, sorted,
+// deduplicated and merge their byte sets; concatenations associate to the
+// right; ε and ∅ are absorbed; r** = r*), which keeps the derivatives of a
+// regex few: equal up to these rules means equal IDs.
+class RegexTerms
+{
+public:
+    using Term = int; // for RegexParser
+    using ByteSet = std::array<std::uint64_t, 4>;
+
+    static constexpr Term Empty = 0;   // ∅, matches nothing
+    static constexpr Term Epsilon = 1; // matches ""
+
+    RegexTerms();
+
+    Term symbol(unsigned char symbol);
+    Term bytes(const ByteSet& set);
+    Term anyOf(std::string_view bytes);
+    Term epsilon() { return Epsilon; }
+    Term unionOf(Term r, Term s);
+    Term concat(Term r, Term s);
+    Term closure(Term r);
+    Term plus(Term r) { return concat(r, closure(r)); }
+    Term group(Term r, int) { return r; } // derivatives do not capture
+
+    bool nullable(Term r) const { return nodes[r]->nullable; }
+
+    // The language { w : c w in L(r) }, memoized
+    Term derivative(Term r, unsigned char c);
+
+    // Bytes that no term reachable from r tells apart share a class;
+    // classCount receives the number of classes.
+    std::array<std::uint8_t, 256> byteClasses(Term r, int* classCount) const;
+
+    std::string toString(Term r) const;
+    std::size_t size() const { return nodes.size(); }
+
+private:
+    enum class Kind : std::uint8_t { Empty, Epsilon, Bytes, Concat, Union, Star };
+
+    struct Node {
+        Kind kind;
+        bool nullable;
+        ByteSet set;                // Bytes
+        std::vector<Term> children; // Concat: 2, Union: >= 2 sorted, Star: 1
+
+        bool operator==(const Node& other) const
+        {
+            return kind == other.kind && set == other.set && children == other.children;
+        }
+    };
+
+    struct NodeHash {
+        std::size_t operator()(const Node& node) const;
+    };
+
+    Term intern(Node&& node);
+    void write(Term r, std::string& out) const;
+    const Node& node(Term r) const { return *nodes[r]; }
+
+    // Keys live in the map; nodes points at them by ID
+    std::unordered_map<Node, Term, NodeHash> ids;
+    std::vector<const Node*> nodes;
+    std::unordered_map<std::uint64_t, Term> derivatives; // r << 8 | c
+};
+
+// ===============
+// Brzozowski
+// ===============
+// DFA construction by regex derivatives: the states are the distinct
+// derivatives of the pattern, one per byte class, and a state accepts when
+// its term is nullable. ∅ becomes DFA::Dead, so the result is comparable
+// with SubsetConstruction's; it has no NFA states behind it. The rewrite
+// rules only catch some equivalent derivatives, so the DFA is often not
+// minimal, more often the longer the pattern; Hopcroft::minimize gives the
+// minimal one.
+class Brzozowski
+{
+public:
+    // With a stateLimit, gives up (empty DFA) once more states than that
+    // are needed, and with a termLimit once more regex terms than that have
+    // been interned (the pattern's own included). When terms is given, it
+    // receives each state's derivative.
+    static DFA fromRegex(const std::string& regex, int stateLimit = 0, int termLimit = 0,
+                         std::vector<std::string>* terms = nullptr);
+};
+
+#endif // BRZOZOWSKI_H
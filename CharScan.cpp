@@ -0,0 +1,89 @@
+#include "CharScan.h"
+
+#if defined(CHARSCAN_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CHARSCAN_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#ifdef CHARSCAN_SSE2
+template <CharScan::RunClass K>
+std::size_t sse2Run(const unsigned char* p, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(CharScan::match16<K>(v)));
+        if (mask != 0xFFFF) return i + CharScan::countTrailingZeros(~mask);
+    }
+    return i + CharScan::scalarRun(K, p + i, n - i);
+}
+#endif
+
+#ifdef CHARSCAN_AVX2
+// unsigned x <= limit, per lane
+__attribute__((target("avx2"))) inline __m256i inRange(__m256i x, char limit)
+{
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(limit)), x);
+}
+
+template <CharScan::RunClass K>
+__attribute__((target("avx2"))) inline __m256i match32(__m256i v)
+{
+    if (K == CharScan::Space) {
+        __m256i m = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+        m = _mm256_or_si256(m, inRange(_mm256_sub_epi8(v, _mm256_set1_epi8('\v')), 2));
+        return m;
+    }
+    __m256i digit = inRange(_mm256_sub_epi8(v, _mm256_set1_epi8('0')), 9);
+    if (K == CharScan::Digit) return digit;
+    __m256i alpha = inRange(_mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a')), 25);
+    __m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(digit, alpha), under);
+}
+
+template <CharScan::RunClass K>
+__attribute__((target("avx2"))) std::size_t avx2Run(const unsigned char* p, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(match32<K>(v)));
+        if (mask != 0xFFFFFFFFu) return i + CharScan::countTrailingZeros(~mask);
+    }
+    return i + sse2Run<K>(p + i, n - i);
+}
+
+const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+#endif
+
+template <CharScan::RunClass K>
+std::size_t longRunOf(const unsigned char* p, std::size_t n)
+{
+#if defined(CHARSCAN_AVX2)
+    if (kHasAvx2) return avx2Run<K>(p, n);
+#endif
+#if defined(CHARSCAN_SSE2)
+    return sse2Run<K>(p, n);
+#else
+    return CharScan::scalarRun(K, p, n);
+#endif
+}
+
+} // namespace
+
+// ==========================
+//   CharScan IMPLEMENTATION
+// ==========================
+
+std::size_t CharScan::longRun(RunClass k, const unsigned char* p, std::size_t n)
+{
+    switch (k) {
+    case Space:      return longRunOf<Space>(p, n);
+    case Identifier: return longRunOf<Identifier>(p, n);
+    case Digit:      return longRunOf<Digit>(p, n);
+    }
+    return 0;
+}
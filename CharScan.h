@@ -0,0 +1,106 @@
+#ifndef CHARSCAN_H
+#define CHARSCAN_H
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHARSCAN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// ===============
+// CharScan
+// ===============
+// Vectorized run finders for the scanner's self-looping states. Each
+// returns the length of the leading run of its class in [p, p + n).
+// The first 16 bytes are checked inline with SSE2 (short runs are the
+// common case); longer runs continue out of line with AVX2 when the CPU
+// has it. Other targets use the scalar loop.
+class CharScan
+{
+public:
+    enum RunClass { Space, Identifier, Digit };
+
+    // ' ', \t, \r, \v, \f  (not \n: the scanner counts lines)
+    static std::size_t spaceRun(const unsigned char* p, std::size_t n) { return run<Space>(p, n); }
+    // [A-Za-z0-9_]
+    static std::size_t identifierRun(const unsigned char* p, std::size_t n) { return run<Identifier>(p, n); }
+    // [0-9]
+    static std::size_t digitRun(const unsigned char* p, std::size_t n) { return run<Digit>(p, n); }
+
+    static bool matches(RunClass k, unsigned char c)
+    {
+        switch (k) {
+        case Space:      return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        case Identifier: return static_cast<unsigned char>((c | 0x20) - 'a') < 26
+                             || static_cast<unsigned char>(c - '0') < 10 || c == '_';
+        case Digit:      return static_cast<unsigned char>(c - '0') < 10;
+        }
+        return false;
+    }
+
+    static std::size_t scalarRun(RunClass k, const unsigned char* p, std::size_t n)
+    {
+        std::size_t i = 0;
+        while (i < n && matches(k, p[i])) ++i;
+        return i;
+    }
+
+#ifdef CHARSCAN_SSE2
+    // 0xFF in every lane whose byte belongs to the class
+    template <RunClass K>
+    static __m128i match16(__m128i v)
+    {
+        auto inRange = [](__m128i x, char limit) { // unsigned x <= limit
+            return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(limit)), x);
+        };
+        if (K == Space) {
+            __m128i m = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+            // \v \f \r are 11..13
+            m = _mm_or_si128(m, inRange(_mm_sub_epi8(v, _mm_set1_epi8('\v')), 2));
+            return m;
+        }
+        __m128i digit = inRange(_mm_sub_epi8(v, _mm_set1_epi8('0')), 9);
+        if (K == Digit) return digit;
+        __m128i alpha = inRange(_mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')), 25);
+        __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        return _mm_or_si128(_mm_or_si128(digit, alpha), under);
+    }
+#endif
+
+    static unsigned countTrailingZeros(unsigned x)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+    }
+
+private:
+    template <RunClass K>
+    static std::size_t run(const unsigned char* p, std::size_t n)
+    {
+#ifdef CHARSCAN_SSE2
+        if (n >= 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match16<K>(v)));
+            if (mask != 0xFFFF) return countTrailingZeros(~mask);
+            return 16 + longRun(K, p + 16, n - 16);
+        }
+#endif
+        return scalarRun(K, p, n);
+    }
+
+    // Continues a run past its first 16 bytes
+    static std::size_t longRun(RunClass k, const unsigned char* p, std::size_t n);
+};
+
+#endif // CHARSCAN_H
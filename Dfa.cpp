@@ -0,0 +1,509 @@
+#include "Dfa.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+
+class ClosureBuilder
+{
+public:
+    explicit ClosureBuilder(const NFA& nfa) : nfa(nfa), mark(nfa.stateCount(), 0), important(nfa.stateCount(), 0)
+    {
+        for (int s = 0; s < nfa.stateCount(); ++s) {
+            bool hasSymbol = false;
+            for (const auto& e : nfa.out(s)) hasSymbol |= !e.epsilon;
+            important[s] = hasSymbol || nfa.isAccept(s);
+        }
+    }
+
+    // Sorted ε-closure of seeds, keeping only the states that matter to the
+    // DFA (a byte edge or accepting). Pure ε states never change a move.
+    std::vector<int> closure(const std::vector<int>& seeds)
+    {
+        ++generation;
+        std::vector<int> result;
+        std::vector<int> work;
+        for (int s : seeds) push(s, result, work);
+        while (!work.empty()) {
+            int s = work.back();
+            work.pop_back();
+            for (const auto& e : nfa.out(s))
+                if (e.epsilon) push(e.to, result, work);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    void push(int s, std::vector<int>& result, std::vector<int>& work)
+    {
+        if (mark[s] == generation) return;
+        mark[s] = generation;
+        if (important[s]) result.push_back(s);
+        work.push_back(s);
+    }
+
+    const NFA& nfa;
+    std::vector<unsigned> mark;
+    std::vector<std::uint8_t> important;
+    unsigned generation = 0;
+};
+
+} // namespace
+
+std::size_t StateSetHash::operator()(const std::vector<int>& set) const
+{
+    std::size_t h = 1469598103934665603ull;
+    for (int s : set) h = (h ^ static_cast<std::size_t>(s)) * 1099511628211ull;
+    return h;
+}
+
+// ==========================
+//   DFA IMPLEMENTATION
+// ==========================
+
+bool DFA::matches(std::string_view input) const
+{
+    if (stateCount == 0) return false;
+    std::int32_t state = startState;
+    for (unsigned char c : input) {
+        state = step(state, c);
+        if (state == Dead) return false;
+    }
+    return isAccepting(state);
+}
+
+NFA DFA::toGraph() const
+{
+    NFABuilder graph;
+    for (int s = 0; s < stateCount; ++s) graph.addState(isAccepting(s));
+    for (int s = 0; s < stateCount; ++s) {
+        for (int c = 0; c < 256; ++c) {
+            std::int32_t t = step(s, static_cast<unsigned char>(c));
+            if (t != Dead) graph.addEdge(s, t, static_cast<unsigned char>(c));
+        }
+    }
+    return graph.build(startState, -1); // accepting states are flagged, not unique
+}
+
+std::array<std::uint8_t, 256> DFA::byteClasses(int* classCount) const
+{
+    // Refine one state at a time: bytes stay together only while they
+    // agree on every row seen so far
+    std::array<std::uint8_t, 256> classes{};
+    int count = 1;
+    std::map<std::pair<int, std::int32_t>, int> split;
+    for (int s = 0; s < stateCount; ++s) {
+        split.clear();
+        for (int c = 0; c < 256; ++c) {
+            auto key = std::make_pair(static_cast<int>(classes[c]), step(s, static_cast<unsigned char>(c)));
+            auto it = split.emplace(key, static_cast<int>(split.size())).first;
+            classes[c] = static_cast<std::uint8_t>(it->second);
+        }
+        count = static_cast<int>(split.size());
+        if (count == 256) break;
+    }
+    if (classCount) *classCount = count;
+    return classes;
+}
+
+// ==========================
+//   PackedDFA IMPLEMENTATION
+// ==========================
+
+PackedDFA::PackedDFA(const DFA& dfa)
+    : startState(dfa.startState),
+      base(dfa.stateCount, 0),
+      accepting(dfa.accepting)
+{
+    classes = dfa.byteClasses(&classTotal);
+    std::vector<int> representative(classTotal);
+    for (int c = 255; c >= 0; --c) representative[classes[c]] = c;
+
+    // Live columns of each row, indexed by class
+    std::vector<std::vector<std::pair<int, std::int32_t>>> rows(dfa.stateCount);
+    for (int s = 0; s < dfa.stateCount; ++s) {
+        for (int k = 0; k < classTotal; ++k) {
+            std::int32_t t = dfa.step(s, static_cast<unsigned char>(representative[k]));
+            if (t != DFA::Dead) rows[s].push_back({k, t});
+        }
+    }
+
+    // First fit, densest rows first; an empty row keeps base 0 and owns
+    // nothing, so every lookup in it misses
+    std::vector<int> order(dfa.stateCount);
+    for (int s = 0; s < dfa.stateCount; ++s) order[s] = s;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return rows[a].size() > rows[b].size(); });
+
+    std::size_t firstFree = 0; // no free entry below this
+    for (int s : order) {
+        const auto& row = rows[s];
+        if (row.empty()) continue;
+        std::size_t b = firstFree > static_cast<std::size_t>(row[0].first) ? firstFree - row[0].first : 0;
+        for (;; ++b) {
+            bool fits = true;
+            for (const auto& [k, t] : row) {
+                if (b + k < entries.size() && entries[b + k].owner != -1) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) break;
+        }
+        if (entries.size() < b + row.back().first + 1) entries.resize(b + row.back().first + 1);
+        for (const auto& [k, t] : row) entries[b + k] = {s, t};
+        base[s] = static_cast<std::int32_t>(b);
+        while (firstFree < entries.size() && entries[firstFree].owner != -1) ++firstFree;
+    }
+
+    // Room for the full class range past the highest base, so step never
+    // reads out of bounds
+    std::size_t highest = 0;
+    for (std::int32_t b : base) highest = std::max(highest, static_cast<std::size_t>(b));
+    entries.resize(std::max(entries.size(), highest + classTotal));
+}
+
+bool PackedDFA::matches(std::string_view input) const
+{
+    if (base.empty()) return false;
+    std::int32_t state = startState;
+    for (unsigned char c : input) {
+        state = step(state, c);
+        if (state == DFA::Dead) return false;
+    }
+    return isAccepting(state);
+}
+
+std::size_t PackedDFA::tableBytes() const
+{
+    return sizeof(classes) + base.size() * sizeof(base[0]) + entries.size() * sizeof(Entry);
+}
+
+// ==========================
+//   SubsetConstruction IMPLEMENTATION
+// ==========================
+
+DFA SubsetConstruction::determinize(const NFA& nfa, int stateLimit)
+{
+    DFA dfa;
+    if (nfa.stateCount() == 0) return dfa;
+
+    ClosureBuilder closures(nfa);
+
+    // Keys live in the map; sets points at them by DFA state ID
+    std::unordered_map<std::vector<int>, int, StateSetHash> ids;
+    std::vector<const std::vector<int>*> sets;
+
+    auto intern = [&](std::vector<int>&& set) {
+        auto [it, inserted] = ids.try_emplace(std::move(set), static_cast<int>(sets.size()));
+        if (inserted) {
+            const auto& members = it->first;
+            bool accept = std::any_of(members.begin(), members.end(), [&](int s) { return nfa.isAccept(s); });
+            dfa.next.resize(dfa.next.size() + 256, DFA::Dead);
+            dfa.accepting.push_back(accept ? 1 : 0);
+            sets.push_back(&members);
+        }
+        return it->second;
+    };
+
+    dfa.startState = intern(closures.closure({nfa.startState}));
+
+    std::vector<std::vector<int>> moves(256);
+    std::vector<int> used;
+    for (std::size_t d = 0; d < sets.size(); ++d) {
+        used.clear();
+        for (int s : *sets[d]) {
+            for (const auto& e : nfa.out(s)) {
+                if (e.epsilon) continue;
+                if (moves[e.symbol].empty()) used.push_back(e.symbol);
+                moves[e.symbol].push_back(e.to);
+            }
+        }
+        for (int c : used) {
+            int target = intern(closures.closure(moves[c]));
+            dfa.next[d * 256 + c] = target;
+            moves[c].clear();
+        }
+        if (stateLimit > 0 && static_cast<int>(sets.size()) > stateLimit) return DFA{};
+    }
+
+    dfa.stateCount = static_cast<int>(sets.size());
+    dfa.nfaStates.reserve(sets.size());
+    for (const auto* set : sets) dfa.nfaStates.push_back(*set);
+    return dfa;
+}
+
+// ==========================
+//   LazyDFA IMPLEMENTATION
+// ==========================
+
+LazyDFA::LazyDFA(const NFA& nfa, std::size_t maxStates)
+    : nfa(nfa), maxStates(std::max<std::size_t>(maxStates, 2))
+{
+}
+
+void LazyDFA::flush()
+{
+    states.clear();
+    ids.clear();
+    startState = Unknown;
+    ++flushes;
+}
+
+int LazyDFA::intern(std::vector<int>&& set)
+{
+    auto it = ids.find(set);
+    if (it != ids.end()) return it->second;
+    if (states.size() >= maxStates) flush();
+
+    int id = static_cast<int>(states.size());
+    auto inserted = ids.emplace(std::move(set), id).first;
+    State state;
+    state.next.fill(Unknown);
+    state.set = &inserted->first;
+    state.accept = std::any_of(state.set->begin(), state.set->end(), [&](int s) { return nfa.isAccept(s); });
+    states.push_back(state);
+    return id;
+}
+
+bool LazyDFA::matches(std::string_view input)
+{
+    if (nfa.stateCount() == 0) return false;
+    ClosureBuilder closures(nfa);
+
+    if (startState == Unknown) startState = intern(closures.closure({nfa.startState}));
+    std::int32_t state = startState;
+    std::vector<int> moved;
+
+    for (unsigned char c : input) {
+        std::int32_t target = states[state].next[c];
+        if (target == Unknown) {
+            moved.clear();
+            for (int s : *states[state].set)
+                for (const auto& e : nfa.out(s))
+                    if (!e.epsilon && e.symbol == c) moved.push_back(e.to);
+
+            if (moved.empty()) {
+                target = DFA::Dead;
+                states[state].next[c] = target;
+            } else {
+                std::size_t generation = flushes;
+                target = intern(closures.closure(moved));
+                // A flush dropped the source state; only the target survives
+                if (generation == flushes) states[state].next[c] = target;
+            }
+        }
+        if (target == DFA::Dead) return false;
+        state = target;
+    }
+    return states[state].accept;
+}
+
+// ==========================
+//   Hopcroft IMPLEMENTATION
+// ==========================
+
+namespace {
+
+// Blocks are contiguous ranges of elems; marked elements are swapped to the
+// front of their block so a split is O(marked).
+class RefinablePartition
+{
+public:
+    explicit RefinablePartition(int size) : elems(size), location(size), blockOf(size, 0)
+    {
+        for (int i = 0; i < size; ++i) elems[i] = location[i] = i;
+        first.push_back(0);
+        end.push_back(size);
+        marked.push_back(0);
+    }
+
+    int blockCount() const { return static_cast<int>(first.size()); }
+    int block(int e) const { return blockOf[e]; }
+    int size(int b) const { return end[b] - first[b]; }
+    const int* begin(int b) const { return elems.data() + first[b]; }
+
+    void mark(int e)
+    {
+        int b = blockOf[e];
+        int slot = first[b] + marked[b];
+        if (location[e] < slot) return; // already marked
+        if (marked[b] == 0) touched.push_back(b);
+        int other = elems[slot];
+        std::swap(elems[slot], elems[location[e]]);
+        location[other] = location[e];
+        location[e] = slot;
+        ++marked[b];
+    }
+
+    // Splits every touched block into marked and unmarked parts. onSplit
+    // gets (old block, new block) with the marked part as the new block.
+    template <typename F>
+    void splitTouched(F&& onSplit)
+    {
+        for (int b : touched) {
+            int m = marked[b];
+            marked[b] = 0;
+            if (m == size(b)) continue;
+            int nb = blockCount();
+            first.push_back(first[b]);
+            end.push_back(first[b] + m);
+            marked.push_back(0);
+            first[b] += m;
+            for (int i = first[nb]; i < end[nb]; ++i) blockOf[elems[i]] = nb;
+            onSplit(b, nb);
+        }
+        touched.clear();
+    }
+
+private:
+    std::vector<int> elems, location, blockOf;
+    std::vector<int> first, end, marked;
+    std::vector<int> touched;
+};
+
+} // namespace
+
+DFA Hopcroft::minimize(const DFA& dfa, std::vector<int>* labels)
+{
+    if (dfa.stateCount == 0) return dfa;
+
+    int classCount = 0;
+    const auto classes = dfa.byteClasses(&classCount);
+    std::vector<int> representative(classCount);
+    for (int c = 255; c >= 0; --c) representative[classes[c]] = c;
+
+    // Dead becomes an explicit sink so the DFA is complete
+    const int n = dfa.stateCount + 1;
+    const int sink = dfa.stateCount;
+    auto target = [&](int s, int k) {
+        if (s == sink) return sink;
+        std::int32_t t = dfa.step(s, static_cast<unsigned char>(representative[k]));
+        return t == DFA::Dead ? sink : static_cast<int>(t);
+    };
+
+    // Inverse transitions per class in CSR form: preds[k][t] lists sources
+    std::vector<int> predStart(static_cast<std::size_t>(classCount) * (n + 1), 0);
+    std::vector<int> preds(static_cast<std::size_t>(classCount) * n);
+    for (int k = 0; k < classCount; ++k) {
+        int* start = &predStart[static_cast<std::size_t>(k) * (n + 1)];
+        for (int s = 0; s < n; ++s) ++start[target(s, k) + 1];
+        for (int t = 0; t < n; ++t) start[t + 1] += start[t];
+        std::vector<int> fill(start, start + n);
+        for (int s = 0; s < n; ++s) preds[static_cast<std::size_t>(k) * n + fill[target(s, k)]++] = s;
+    }
+
+    // Initial partition: accepting vs the rest, or one block per label
+    // with the sink among the -1 states
+    RefinablePartition partition(n);
+    if (labels) {
+        std::map<int, std::vector<int>> byLabel;
+        for (int s = 0; s < dfa.stateCount; ++s) byLabel[(*labels)[s]].push_back(s);
+        for (const auto& group : byLabel) {
+            if (group.first == -1) continue;
+            for (int s : group.second) partition.mark(s);
+            partition.splitTouched([](int, int) {});
+        }
+    } else {
+        for (int s = 0; s < dfa.stateCount; ++s)
+            if (dfa.isAccepting(s)) partition.mark(s);
+        partition.splitTouched([](int, int) {});
+    }
+
+    std::vector<std::uint8_t> inWork;
+    std::vector<std::pair<int, int>> work;
+    auto push = [&](int b, int k) {
+        std::size_t slot = static_cast<std::size_t>(b) * classCount + k;
+        if (inWork.size() <= slot) inWork.resize((static_cast<std::size_t>(b) + 1) * classCount, 0);
+        if (inWork[slot]) return;
+        inWork[slot] = 1;
+        work.push_back({b, k});
+    };
+    auto queued = [&](int b, int k) {
+        std::size_t slot = static_cast<std::size_t>(b) * classCount + k;
+        return slot < inWork.size() && inWork[slot];
+    };
+
+    // All initial blocks but one suffice as splitters; leave out the largest
+    int largest = 0;
+    for (int b = 1; b < partition.blockCount(); ++b)
+        if (partition.size(b) > partition.size(largest)) largest = b;
+    for (int b = 0; b < partition.blockCount(); ++b)
+        if (b != largest)
+            for (int k = 0; k < classCount; ++k) push(b, k);
+
+    std::vector<int> splitter;
+    while (!work.empty()) {
+        auto [b, k] = work.back();
+        work.pop_back();
+        inWork[static_cast<std::size_t>(b) * classCount + k] = 0;
+
+        splitter.assign(partition.begin(b), partition.begin(b) + partition.size(b));
+        const int* start = &predStart[static_cast<std::size_t>(k) * (n + 1)];
+        const int* sources = &preds[static_cast<std::size_t>(k) * n];
+        for (int t : splitter)
+            for (int i = start[t]; i < start[t + 1]; ++i) partition.mark(sources[i]);
+
+        partition.splitTouched([&](int oldBlock, int newBlock) {
+            for (int a = 0; a < classCount; ++a) {
+                if (queued(oldBlock, a)) push(newBlock, a);
+                else push(partition.size(newBlock) < partition.size(oldBlock) ? newBlock : oldBlock, a);
+            }
+        });
+    }
+
+    // Number live blocks in BFS order from the start state
+    const int sinkBlock = partition.block(sink);
+    std::vector<int> order(partition.blockCount(), -1);
+    std::vector<int> blocks;
+    std::queue<int> bfs;
+    order[partition.block(dfa.startState)] = 0;
+    blocks.push_back(partition.block(dfa.startState));
+    bfs.push(dfa.startState);
+    while (!bfs.empty()) {
+        int s = bfs.front();
+        bfs.pop();
+        for (int k = 0; k < classCount; ++k) {
+            int t = target(s, k);
+            int tb = partition.block(t);
+            if (tb == sinkBlock || order[tb] != -1) continue;
+            order[tb] = static_cast<int>(blocks.size());
+            blocks.push_back(tb);
+            bfs.push(*partition.begin(tb));
+        }
+    }
+
+    DFA result;
+    result.startState = 0;
+    result.stateCount = static_cast<int>(blocks.size());
+    result.next.assign(static_cast<std::size_t>(result.stateCount) * 256, DFA::Dead);
+    result.accepting.resize(result.stateCount);
+    result.nfaStates.resize(result.stateCount);
+
+    for (int d = 0; d < result.stateCount; ++d) {
+        int b = blocks[d];
+        int s = *partition.begin(b);
+        result.accepting[d] = dfa.accepting[s];
+        for (int c = 0; c < 256; ++c) {
+            int t = target(s, classes[c]);
+            int tb = partition.block(t);
+            if (tb != sinkBlock) result.next[d * 256 + c] = order[tb];
+        }
+        auto& members = result.nfaStates[d];
+        for (const int* e = partition.begin(b); e != partition.begin(b) + partition.size(b); ++e)
+            if (*e != sink && static_cast<std::size_t>(*e) < dfa.nfaStates.size())
+                members.insert(members.end(), dfa.nfaStates[*e].begin(), dfa.nfaStates[*e].end());
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(), members.end()), members.end());
+    }
+
+    if (labels) {
+        std::vector<int> merged(result.stateCount);
+        for (int d = 0; d < result.stateCount; ++d) merged[d] = (*labels)[*partition.begin(blocks[d])];
+        labels->swap(merged);
+    }
+    return result;
+}
@@ -0,0 +1,154 @@
+#ifndef DFA_H
+#define DFA_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Nfa.h"
+
+struct StateSetHash {
+    std::size_t operator()(const std::vector<int>& set) const;
+};
+
+// ===============
+// DFA
+// ===============
+// Deterministic automaton over bytes with dense state IDs 0..stateCount-1.
+// next holds one row of 256 targets per state; Dead means no transition.
+struct DFA {
+    static constexpr std::int32_t Dead = -1;
+
+    int startState = 0;
+    int stateCount = 0;
+    std::vector<std::int32_t> next;       // stateCount * 256
+    std::vector<std::uint8_t> accepting;  // per state
+    std::vector<std::vector<int>> nfaStates; // NFA states (with a symbol edge or accepting) behind each state
+
+    std::int32_t step(int state, unsigned char c) const { return next[state * 256 + c]; }
+    bool isAccepting(int state) const { return accepting[state] != 0; }
+
+    // Whole-string match
+    bool matches(std::string_view input) const;
+
+    // Bytes with identical columns in every state share a class. Returns
+    // the class of each byte; classCount receives the number of classes.
+    std::array<std::uint8_t, 256> byteClasses(int* classCount) const;
+
+    // Same states and edges as an NFA (one edge per byte), so the diagram
+    // code can draw either automaton.
+    NFA toGraph() const;
+};
+
+// ===============
+// PackedDFA
+// ===============
+// A DFA stored over its byte classes with row displacement ("comb")
+// packing: all rows share one entry array, each shifted by its own base so
+// that their live entries never collide, and an entry is only taken when
+// its owner is the current state. Sparse automata such as the token and
+// regex DFAs shrink from 1 KiB per state to a few bytes per transition,
+// small enough to stay in L1 while scanning.
+class PackedDFA
+{
+public:
+    PackedDFA() = default;
+    explicit PackedDFA(const DFA& dfa);
+
+    std::int32_t step(int state, unsigned char c) const
+    {
+        const Entry& e = entries[base[state] + classes[c]];
+        return e.owner == state ? e.target : DFA::Dead;
+    }
+    bool isAccepting(int state) const { return accepting[state] != 0; }
+
+    // Whole-string match
+    bool matches(std::string_view input) const;
+
+    int stateCount() const { return static_cast<int>(base.size()); }
+    int classCount() const { return classTotal; }
+    std::size_t tableBytes() const; // class map, bases and entries
+
+private:
+    struct Entry {
+        std::int32_t owner = -1; // state whose row holds this entry
+        std::int32_t target = DFA::Dead;
+    };
+
+    std::array<std::uint8_t, 256> classes{};
+    int classTotal = 0;
+    int startState = 0;
+    std::vector<std::int32_t> base;      // per state
+    std::vector<std::uint8_t> accepting; // per state
+    std::vector<Entry> entries;
+};
+
+// ===============
+// SubsetConstruction
+// ===============
+class SubsetConstruction
+{
+public:
+    // With a stateLimit, gives up (empty DFA) once more states than that
+    // are needed.
+    static DFA determinize(const NFA& nfa, int stateLimit = 0);
+};
+
+// ===============
+// LazyDFA
+// ===============
+// Subset construction on demand: DFA states are built from NFA state sets
+// only when the input reaches them, and kept in a cache of at most
+// maxStates states that is flushed when full. Each byte costs O(1) once
+// its state is cached and O(NFA) otherwise, so matching stays linear with
+// bounded memory even for patterns whose full DFA is exponential.
+class LazyDFA
+{
+public:
+    explicit LazyDFA(const NFA& nfa, std::size_t maxStates = 1024);
+
+    // Whole-string match (fills the cache, hence non-const)
+    bool matches(std::string_view input);
+
+    std::size_t cachedStates() const { return states.size(); }
+    std::size_t flushCount() const { return flushes; }
+
+private:
+    static constexpr std::int32_t Unknown = -2;
+
+    struct State {
+        std::array<std::int32_t, 256> next; // Unknown until first taken
+        const std::vector<int>* set;        // key in ids
+        bool accept;
+    };
+
+    int intern(std::vector<int>&& set);
+    void flush();
+
+    NFA nfa;
+    std::size_t maxStates;
+    std::unordered_map<std::vector<int>, int, StateSetHash> ids;
+    std::vector<State> states;
+    std::int32_t startState = Unknown;
+    std::size_t flushes = 0;
+};
+
+// ===============
+// Hopcroft
+// ===============
+// DFA minimization by partition refinement over byte classes,
+// O(k n log n) for n states and k classes.
+class Hopcroft
+{
+public:
+    // Equivalent DFA with the fewest states, numbered in BFS order from
+    // the start state. nfaStates of merged states are unioned. With labels
+    // (one per state, -1 for states that accept nothing of their own),
+    // states with different labels are never merged and labels is
+    // rewritten to describe the result's states.
+    static DFA minimize(const DFA& dfa, std::vector<int>* labels = nullptr);
+};
+
+#endif // DFA_H
@@ -0,0 +1,380 @@
+#include "Grammar.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+// ==========================
+//   Grammar IMPLEMENTATION
+// ==========================
+
+namespace {
+
+const char* const kEmpty = "ε";
+
+std::vector<std::string_view> words(std::string_view line)
+{
+    std::vector<std::string_view> out;
+    std::size_t pos = 0;
+    while (pos < line.size()) {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) ++pos;
+        std::size_t start = pos;
+        while (pos < line.size() && !std::isspace(static_cast<unsigned char>(line[pos]))) ++pos;
+        if (pos > start) out.push_back(line.substr(start, pos - start));
+    }
+    return out;
+}
+
+// Sets the flags of from in into, which may be longer; true if any was new
+bool merge(std::vector<std::uint8_t>& into, const std::vector<std::uint8_t>& from)
+{
+    bool changed = false;
+    for (std::size_t t = 0; t < from.size(); ++t) {
+        if (from[t] && !into[t]) {
+            into[t] = 1;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+} // namespace
+
+Grammar Grammar::fromText(std::string_view text, std::string* error)
+{
+    // Split into rules first: nonterminals must be known before numbering
+    struct Rule {
+        std::string_view lhs;
+        std::vector<std::string_view> rhs; // alternatives separated by "|"
+    };
+    std::vector<Rule> parsed;
+    int lineNumber = 0;
+    while (!text.empty()) {
+        std::size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+        ++lineNumber;
+
+        std::vector<std::string_view> w = words(line);
+        if (w.empty() || w[0][0] == '#') continue;
+        if (w.size() < 2 || w[1] != "->") {
+            if (error) *error = "line " + std::to_string(lineNumber) + ": expected \"Lhs -> ...\"";
+            return Grammar();
+        }
+        parsed.push_back({w[0], std::vector<std::string_view>(w.begin() + 2, w.end())});
+    }
+
+    Grammar g;
+    std::vector<std::string_view> nonterminals;
+    for (const auto& rule : parsed)
+        if (std::find(nonterminals.begin(), nonterminals.end(), rule.lhs) == nonterminals.end())
+            nonterminals.push_back(rule.lhs);
+
+    g.names.push_back("$");
+    for (const auto& rule : parsed) {
+        for (std::string_view w : rule.rhs) {
+            if (w == "|" || w == kEmpty) continue;
+            if (std::find(nonterminals.begin(), nonterminals.end(), w) != nonterminals.end()) continue;
+            if (g.symbol(w) == -1) g.names.emplace_back(w);
+        }
+    }
+    g.terminals = g.symbolCount();
+    for (std::string_view n : nonterminals) g.names.emplace_back(n);
+    if (!parsed.empty()) g.start = g.symbol(parsed[0].lhs);
+
+    for (const auto& rule : parsed) {
+        const int lhs = g.symbol(rule.lhs);
+        Production p{lhs, static_cast<int>(g.rhs.size()), 0};
+        for (std::string_view w : rule.rhs) {
+            if (w == "|") {
+                p.last = static_cast<int>(g.rhs.size());
+                g.rules.push_back(p);
+                p.first = p.last;
+            } else if (w != kEmpty) {
+                g.rhs.push_back(g.symbol(w));
+            }
+        }
+        p.last = static_cast<int>(g.rhs.size());
+        g.rules.push_back(p);
+    }
+    g.computeSets();
+    return g;
+}
+
+int Grammar::symbol(std::string_view name) const
+{
+    for (std::size_t s = 0; s < names.size(); ++s)
+        if (names[s] == name) return static_cast<int>(s);
+    return -1;
+}
+
+std::string Grammar::productionText(int production) const
+{
+    const Production& p = rules[production];
+    std::string text = names[p.lhs] + " ->";
+    if (p.first == p.last) text += " ε";
+    for (int i = p.first; i < p.last; ++i) text += ' ' + names[rhs[i]];
+    return text;
+}
+
+bool Grammar::firstOf(int first, int last, TerminalSet& into) const
+{
+    for (int i = first; i < last; ++i) {
+        merge(into, firsts[rhs[i]]);
+        if (!nullables[rhs[i]]) return false;
+    }
+    return true;
+}
+
+void Grammar::computeSets()
+{
+    const int n = symbolCount();
+    nullables.assign(n, 0);
+    firsts.assign(n, TerminalSet(terminals, 0));
+    follows.assign(n, TerminalSet(terminals, 0));
+
+    // FIRST and nullable, to a fixed point
+    for (int t = 0; t < terminals; ++t) firsts[t][t] = 1;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& p : rules) {
+            bool allNullable = true;
+            for (int i = p.first; i < p.last && allNullable; ++i) {
+                changed |= merge(firsts[p.lhs], firsts[rhs[i]]);
+                allNullable = nullables[rhs[i]] != 0;
+            }
+            if (allNullable && !nullables[p.lhs]) {
+                nullables[p.lhs] = 1;
+                changed = true;
+            }
+        }
+    }
+
+    // FOLLOW: what can come after each nonterminal occurrence
+    if (start >= 0) follows[start][End] = 1;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& p : rules) {
+            for (int i = p.first; i < p.last; ++i) {
+                const int b = rhs[i];
+                if (isTerminal(b)) continue;
+                bool restNullable = true;
+                for (int j = i + 1; j < p.last && restNullable; ++j) {
+                    changed |= merge(follows[b], firsts[rhs[j]]);
+                    restNullable = nullables[rhs[j]] != 0;
+                }
+                if (restNullable) changed |= merge(follows[b], follows[p.lhs]);
+            }
+        }
+    }
+}
+
+// ==========================
+//   TerminalMap IMPLEMENTATION
+// ==========================
+
+TerminalMap::TerminalMap(const Grammar& grammar)
+    : id(grammar.symbol("id")), number(grammar.symbol("number"))
+{
+    // "$" is only ever the end marker, never a token's spelling
+    for (int t = Grammar::End + 1; t < grammar.terminalCount(); ++t)
+        if (t != id && t != number) spelled.emplace(grammar.name(t), t);
+}
+
+// ==========================
+//   LL1Table IMPLEMENTATION
+// ==========================
+
+LL1Table::LL1Table(const Grammar& grammar)
+    : terminals(grammar.terminalCount()),
+      table(static_cast<std::size_t>(grammar.nonterminalCount()) * grammar.terminalCount(), Error)
+{
+    const auto& rules = grammar.productions();
+
+    // Predict sets: FIRST(rhs), plus FOLLOW(lhs) when rhs is nullable
+    for (std::size_t r = 0; r < rules.size(); ++r) {
+        const auto& p = rules[r];
+        Grammar::TerminalSet predict(terminals, 0);
+        if (grammar.firstOf(p.first, p.last, predict)) merge(predict, grammar.follow(p.lhs));
+
+        for (int t = 0; t < terminals; ++t) {
+            if (!predict[t]) continue;
+            std::int16_t& entry = table[(p.lhs - terminals) * terminals + t];
+            if (entry == Error) {
+                entry = static_cast<std::int16_t>(r);
+            } else {
+                clashes.push_back(grammar.name(p.lhs) + " on " + grammar.name(t) + ": productions "
+                                  + std::to_string(entry) + " and " + std::to_string(r));
+            }
+        }
+    }
+}
+
+// ==========================
+//   LalrTable IMPLEMENTATION
+// ==========================
+
+LalrTable::LalrTable(const Grammar& grammar)
+    : terminals(grammar.terminalCount()), nonterminals(grammar.nonterminalCount())
+{
+    const auto& rules = grammar.productions();
+    const auto& rhs = grammar.rhsSymbols();
+    const int symbols = grammar.symbolCount();
+    const int augmented = static_cast<int>(rules.size()); // S' -> start
+    const int lookaheads = terminals + 1;                  // plus the probe '#'
+    const int probe = terminals;
+
+    // Items are numbered production by production, one per dot position
+    std::vector<int> itemRule, itemDot, firstItem;
+    for (int r = 0; r <= augmented; ++r) {
+        firstItem.push_back(static_cast<int>(itemRule.size()));
+        const int length = r == augmented ? 1 : rules[r].last - rules[r].first;
+        for (int dot = 0; dot <= length; ++dot) {
+            itemRule.push_back(r);
+            itemDot.push_back(dot);
+        }
+    }
+    auto next = [&](int item) { // symbol after the dot, -1 at the end
+        const int r = itemRule[item], dot = itemDot[item];
+        if (r == augmented) return dot == 0 ? grammar.startSymbol() : -1;
+        return rules[r].first + dot < rules[r].last ? rhs[rules[r].first + dot] : -1;
+    };
+    std::vector<std::vector<int>> byLhs(symbols);
+    for (int r = 0; r < augmented; ++r) byLhs[rules[r].lhs].push_back(r);
+
+    // LR(0) item sets, identified by their sorted kernels
+    std::vector<std::vector<int>> kernels = {{firstItem[augmented]}};
+    std::map<std::vector<int>, int> stateOf = {{kernels[0], 0}};
+    std::vector<int> transitions; // states x symbols, -1 if none
+    std::vector<std::uint8_t> expanded(symbols);
+    for (std::size_t s = 0; s < kernels.size(); ++s) {
+        std::vector<int> items = kernels[s];
+        std::fill(expanded.begin(), expanded.end(), 0);
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            const int x = next(items[i]);
+            if (x < terminals || expanded[x]) continue;
+            expanded[x] = 1;
+            for (int r : byLhs[x]) items.push_back(firstItem[r]);
+        }
+
+        std::vector<std::vector<int>> moves(symbols);
+        for (int item : items)
+            if (next(item) >= 0) moves[next(item)].push_back(item + 1);
+        transitions.resize((s + 1) * symbols, -1);
+        for (int x = 0; x < symbols; ++x) {
+            if (moves[x].empty()) continue;
+            std::sort(moves[x].begin(), moves[x].end());
+            moves[x].erase(std::unique(moves[x].begin(), moves[x].end()), moves[x].end());
+            auto found = stateOf.emplace(moves[x], static_cast<int>(kernels.size()));
+            if (found.second) kernels.push_back(moves[x]);
+            transitions[s * symbols + x] = found.first->second;
+        }
+    }
+    states = static_cast<int>(kernels.size());
+
+    // LR(1) closure of items paired with lookahead sets
+    using Seeds = std::vector<std::pair<int, Grammar::TerminalSet>>;
+    std::vector<int> slot(itemRule.size(), -1);
+    auto closure = [&](Seeds items) {
+        for (std::size_t i = 0; i < items.size(); ++i) slot[items[i].first] = static_cast<int>(i);
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (std::size_t i = 0; i < items.size(); ++i) {
+                const int item = items[i].first;
+                const int x = next(item);
+                if (x < terminals) continue;
+
+                Grammar::TerminalSet follow(lookaheads, 0);
+                bool restNullable = true;
+                if (itemRule[item] != augmented) {
+                    const auto& p = rules[itemRule[item]];
+                    restNullable = grammar.firstOf(p.first + itemDot[item] + 1, p.last, follow);
+                }
+                if (restNullable) merge(follow, items[i].second);
+
+                for (int r : byLhs[x]) {
+                    const int added = firstItem[r];
+                    if (slot[added] == -1) {
+                        slot[added] = static_cast<int>(items.size());
+                        items.emplace_back(added, follow);
+                        changed = true;
+                    } else {
+                        changed |= merge(items[slot[added]].second, follow);
+                    }
+                }
+            }
+        }
+        for (const auto& item : items) slot[item.first] = -1;
+        return items;
+    };
+
+    // Kernel item k of state s has lookahead set kernelBase[s] + k
+    std::vector<int> kernelBase(states + 1, 0);
+    for (int s = 0; s < states; ++s) kernelBase[s + 1] = kernelBase[s] + static_cast<int>(kernels[s].size());
+    auto kernelIndex = [&](int s, int item) {
+        auto at = std::lower_bound(kernels[s].begin(), kernels[s].end(), item);
+        return kernelBase[s] + static_cast<int>(at - kernels[s].begin());
+    };
+    std::vector<Grammar::TerminalSet> lookahead(kernelBase[states], Grammar::TerminalSet(lookaheads, 0));
+    std::vector<std::vector<int>> propagatesTo(kernelBase[states]);
+    lookahead[0][Grammar::End] = 1;
+
+    // Closing each kernel item over the probe '#' shows which lookaheads
+    // its successors get spontaneously and which they inherit from it
+    for (int s = 0; s < states; ++s) {
+        for (int kernel : kernels[s]) {
+            Grammar::TerminalSet probeOnly(lookaheads, 0);
+            probeOnly[probe] = 1;
+            for (const auto& [item, set] : closure({{kernel, probeOnly}})) {
+                const int x = next(item);
+                if (x < 0) continue;
+                const int target = kernelIndex(transitions[s * symbols + x], item + 1);
+                for (int t = 0; t < terminals; ++t)
+                    if (set[t]) lookahead[target][t] = 1;
+                if (set[probe]) propagatesTo[kernelIndex(s, kernel)].push_back(target);
+            }
+        }
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (std::size_t k = 0; k < propagatesTo.size(); ++k)
+            for (int target : propagatesTo[k]) changed |= merge(lookahead[target], lookahead[k]);
+    }
+
+    actions.assign(static_cast<std::size_t>(states) * terminals, Error);
+    gotos.assign(static_cast<std::size_t>(states) * nonterminals, -1);
+    auto describe = [&](std::int16_t a) {
+        if (a == Accept) return std::string("accept");
+        if (a > 0) return "shift " + std::to_string(a - 1);
+        return "reduce " + grammar.productionText(-a - 1);
+    };
+    auto setAction = [&](int s, int t, std::int16_t a) {
+        std::int16_t& entry = actions[s * terminals + t];
+        if (entry == Error || entry == a) {
+            entry = a;
+            return;
+        }
+        clashes.push_back("state " + std::to_string(s) + " on " + grammar.name(t) + ": " + describe(entry)
+                          + " / " + describe(a));
+        // Shift wins over reduce, the earlier production over a later one
+        if (entry < 0 && entry != Accept && (a > 0 || a > entry)) entry = a;
+    };
+
+    for (int s = 0; s < states; ++s) {
+        Seeds seeds;
+        for (int kernel : kernels[s]) seeds.emplace_back(kernel, lookahead[kernelIndex(s, kernel)]);
+        for (const auto& [item, follow] : closure(std::move(seeds))) {
+            const int x = next(item);
+            if (x >= 0 && x < terminals) {
+                setAction(s, x, static_cast<std::int16_t>(transitions[s * symbols + x] + 1));
+            } else if (x < 0 && itemRule[item] == augmented) {
+                setAction(s, Grammar::End, Accept);
+            } else if (x < 0) {
+                for (int t = 0; t < terminals; ++t)
+                    if (follow[t]) setAction(s, t, static_cast<std::int16_t>(-itemRule[item] - 1));
+            }
+        }
+        for (int a = terminals; a < symbols; ++a)
+            gotos[s * nonterminals + a - terminals] = static_cast<std::int16_t>(transitions[s * symbols + a]);
+    }
+}
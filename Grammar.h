@@ -0,0 +1,162 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "TokenStream.h"
+
+// ===============
+// Grammar
+// ===============
+// A context-free grammar as data. Symbols are small integers: terminals
+// 0..terminalCount() - 1, with the end marker "$" as terminal 0, then the
+// nonterminals. Right-hand sides are slices of one flat symbol array.
+class Grammar
+{
+public:
+    static constexpr int End = 0; // "$"
+
+    using TerminalSet = std::vector<std::uint8_t>; // one flag per terminal
+
+    struct Production {
+        int lhs;
+        int first; // rhs is symbols [first, last) of rhsSymbols()
+        int last;
+    };
+
+    // One rule per line, "Lhs -> a B | c | ε", where ε is the empty
+    // right-hand side; '#' starts a comment line. Symbols that appear on
+    // a left-hand side are nonterminals, all others terminals, and the
+    // first rule's left-hand side is the start symbol. Nullable, FIRST and
+    // FOLLOW are computed here. Returns an empty grammar and describes the
+    // line in error if a line has no "->".
+    static Grammar fromText(std::string_view text, std::string* error = nullptr);
+
+    int symbolCount() const { return static_cast<int>(names.size()); }
+    int terminalCount() const { return terminals; }
+    int nonterminalCount() const { return symbolCount() - terminals; }
+    bool isTerminal(int symbol) const { return symbol < terminals; }
+    int startSymbol() const { return start; }
+
+    const std::string& name(int symbol) const { return names[symbol]; }
+    int symbol(std::string_view name) const; // -1 if unknown
+
+    const std::vector<Production>& productions() const { return rules; }
+    const std::vector<int>& rhsSymbols() const { return rhs; }
+    std::string productionText(int production) const; // "Lhs -> a B"
+
+    bool nullable(int symbol) const { return nullables[symbol] != 0; }
+    const TerminalSet& first(int symbol) const { return firsts[symbol]; }
+    const TerminalSet& follow(int nonterminal) const { return follows[nonterminal]; }
+
+    // Adds FIRST of the symbols rhsSymbols()[first, last) to into (which
+    // may be larger than a TerminalSet) and returns whether they are all
+    // nullable
+    bool firstOf(int first, int last, TerminalSet& into) const;
+
+private:
+    void computeSets();
+
+    std::vector<std::string> names;
+    int terminals = 0;
+    int start = -1;
+    std::vector<Production> rules;
+    std::vector<int> rhs;
+    std::vector<std::uint8_t> nullables;
+    std::vector<TerminalSet> firsts;
+    std::vector<TerminalSet> follows;
+};
+
+// ===============
+// TerminalMap
+// ===============
+// Terminals of lexer tokens: numbers are "number" and identifiers "id",
+// keywords and punctuation are looked up by spelling. Tokens the grammar
+// has no terminal for map to Invalid, which no table entry accepts.
+class TerminalMap
+{
+public:
+    static constexpr int Invalid = -1;
+
+    explicit TerminalMap(const Grammar& grammar);
+
+    int operator()(TokenKind kind, std::string_view text) const
+    {
+        if (kind == TokenKind::Number) return number;
+        if (kind == TokenKind::Identifier) return id;
+        auto it = spelled.find(text);
+        return it == spelled.end() ? Invalid : it->second;
+    }
+
+private:
+    int id;
+    int number;
+    std::unordered_map<std::string_view, int> spelled; // keys point into the grammar
+};
+
+// ===============
+// LL1Table
+// ===============
+// The LL(1) parse table of a grammar, from its FIRST and FOLLOW sets:
+// production(A, t) is the production to expand nonterminal A by on
+// lookahead terminal t, or Error. A grammar that is not LL(1) still gets a
+// table (the first production listed wins) and the clashes in conflicts.
+class LL1Table
+{
+public:
+    static constexpr std::int16_t Error = -1;
+
+    explicit LL1Table(const Grammar& grammar);
+
+    int production(int nonterminal, int terminal) const
+    {
+        return table[(nonterminal - terminals) * terminals + terminal];
+    }
+
+    const std::vector<std::string>& conflicts() const { return clashes; }
+
+private:
+    int terminals;
+    std::vector<std::int16_t> table; // nonterminal rows of terminalCount entries
+    std::vector<std::string> clashes;
+};
+
+// ===============
+// LalrTable
+// ===============
+// LALR(1) ACTION and GOTO tables: the canonical LR(0) item sets, with
+// kernel lookaheads generated spontaneously and propagated between item
+// sets to a fixed point (no LR(1) state explosion). Conflicts are resolved
+// as yacc does, shift over reduce and then the earlier production, and
+// described in conflicts().
+class LalrTable
+{
+public:
+    static constexpr std::int16_t Error = 0;
+    static constexpr std::int16_t Accept = std::numeric_limits<std::int16_t>::min();
+
+    explicit LalrTable(const Grammar& grammar);
+
+    // Shift to state a - 1 when a > 0, reduce by production -a - 1 when
+    // a < 0 (other than Accept), Error otherwise
+    std::int16_t action(int state, int terminal) const { return actions[state * terminals + terminal]; }
+    int gotoState(int state, int nonterminal) const { return gotos[state * nonterminals + nonterminal - terminals]; }
+
+    int stateCount() const { return states; }
+    const std::vector<std::string>& conflicts() const { return clashes; }
+
+private:
+    int terminals;
+    int nonterminals;
+    int states = 0;
+    std::vector<std::int16_t> actions; // states x terminals
+    std::vector<std::int16_t> gotos;   // states x nonterminals, -1 if none
+    std::vector<std::string> clashes;
+};
+
+#endif // GRAMMAR_H
@@ -0,0 +1,199 @@
+#include "IncrementalLexer.h"
+#include "Lexer.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
+namespace {
+
+// Lines per chunk after a split; a chunk is split once it holds twice that
+const std::size_t kChunkLines = 256;
+
+// Calls f on each line of text, newlines excluded
+template <class F>
+void forEachLine(std::string_view text, F f)
+{
+    for (;;) {
+        const std::size_t nl = text.find('\n');
+        f(text.substr(0, nl));
+        if (nl == std::string_view::npos) return;
+        text.remove_prefix(nl + 1);
+    }
+}
+
+} // namespace
+
+// ==========================
+//   IncrementalLexer IMPLEMENTATION
+// ==========================
+
+IncrementalLexer::IncrementalLexer()
+{
+    reset(std::string_view());
+}
+
+IncrementalLexer::Line IncrementalLexer::scanLine(std::string_view text)
+{
+    // No token spans a newline and every line starts in the scanner's
+    // initial state, so a line lexes the same on its own
+    Line line;
+    line.text.assign(text);
+    Lexer::scan(line.text, line.tokens);
+    return line;
+}
+
+void IncrementalLexer::reset(std::string_view source)
+{
+    chunks.assign(1, Chunk());
+    forEachLine(source, [&](std::string_view text) {
+        if (chunks.back().lines.size() == kChunkLines) chunks.emplace_back();
+        Chunk& chunk = chunks.back();
+        chunk.lines.push_back(scanLine(text));
+        chunk.tokenCount += chunk.lines.back().tokens.size();
+    });
+    reindex();
+}
+
+TokenSplice IncrementalLexer::replaceLines(int firstLine, int oldLineCount, std::string_view text)
+{
+    std::vector<Line> fresh;
+    forEachLine(text, [&](std::string_view line) { fresh.push_back(scanLine(line)); });
+
+    const std::size_t c = chunkOfLine(firstLine);
+    const std::size_t k = static_cast<std::size_t>(firstLine - chunkLines[c]);
+
+    TokenSplice splice;
+    splice.first = chunkTokens[c];
+    for (std::size_t i = 0; i < k; ++i) splice.first += chunks[c].lines[i].tokens.size();
+
+    // Drop the old lines, which may run on into the following chunks
+    std::size_t remaining = static_cast<std::size_t>(oldLineCount);
+    for (std::size_t cc = c, kk = k; remaining > 0 && cc < chunks.size(); ++cc, kk = 0) {
+        Chunk& chunk = chunks[cc];
+        const std::size_t n = std::min(remaining, chunk.lines.size() - kk);
+        for (std::size_t i = kk; i < kk + n; ++i) {
+            splice.removed += chunk.lines[i].tokens.size();
+            chunk.tokenCount -= chunk.lines[i].tokens.size();
+        }
+        chunk.lines.erase(chunk.lines.begin() + kk, chunk.lines.begin() + kk + n);
+        remaining -= n;
+    }
+
+    Chunk& chunk = chunks[c];
+    for (const Line& line : fresh) splice.inserted += line.tokens.size();
+    chunk.tokenCount += splice.inserted;
+    chunk.lines.insert(chunk.lines.begin() + k, std::make_move_iterator(fresh.begin()),
+                       std::make_move_iterator(fresh.end()));
+
+    if (chunk.lines.size() >= 2 * kChunkLines) splitChunk(c);
+    chunks.erase(std::remove_if(chunks.begin() + c + 1, chunks.end(),
+                                [](const Chunk& ch) { return ch.lines.empty(); }),
+                 chunks.end());
+    reindex();
+    return splice;
+}
+
+// Cuts chunk c into chunks of kChunkLines lines
+void IncrementalLexer::splitChunk(std::size_t c)
+{
+    std::vector<Line> lines = std::move(chunks[c].lines);
+    std::vector<Chunk> pieces((lines.size() + kChunkLines - 1) / kChunkLines);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        Chunk& piece = pieces[i / kChunkLines];
+        piece.tokenCount += lines[i].tokens.size();
+        piece.lines.push_back(std::move(lines[i]));
+    }
+    chunks.erase(chunks.begin() + c);
+    chunks.insert(chunks.begin() + c, std::make_move_iterator(pieces.begin()),
+                  std::make_move_iterator(pieces.end()));
+}
+
+void IncrementalLexer::reindex()
+{
+    chunkTokens.resize(chunks.size());
+    chunkLines.resize(chunks.size());
+    tokenTotal = 0;
+    lineTotal = 0;
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+        chunkTokens[c] = tokenTotal;
+        chunkLines[c] = lineTotal;
+        tokenTotal += chunks[c].tokenCount;
+        lineTotal += static_cast<int>(chunks[c].lines.size());
+    }
+}
+
+// Last chunk starting at or before line (chunks are never empty)
+std::size_t IncrementalLexer::chunkOfLine(int line) const
+{
+    auto it = std::upper_bound(chunkLines.begin(), chunkLines.end(), line);
+    return static_cast<std::size_t>(it - chunkLines.begin()) - 1;
+}
+
+IncrementalLexer::Position IncrementalLexer::locate(std::size_t token) const
+{
+    // Chunks without tokens share their start with the next one, so the
+    // last chunk starting at or before token is the one that holds it
+    auto it = std::upper_bound(chunkTokens.begin(), chunkTokens.end(), token);
+    const std::size_t c = static_cast<std::size_t>(it - chunkTokens.begin()) - 1;
+
+    std::size_t index = token - chunkTokens[c];
+    int lineNumber = chunkLines[c];
+    for (const Line& line : chunks[c].lines) {
+        if (index < line.tokens.size()) return {&line, lineNumber, index};
+        index -= line.tokens.size();
+        ++lineNumber;
+    }
+    return {nullptr, lineNumber, 0}; // past the last token
+}
+
+Token IncrementalLexer::token(std::size_t i) const
+{
+    const Position p = locate(i);
+    Token t = p.line->tokens[p.index];
+    t.line = static_cast<std::uint32_t>(p.lineNumber + 1);
+    return t;
+}
+
+std::string_view IncrementalLexer::text(std::size_t i) const
+{
+    const Position p = locate(i);
+    const Token& t = p.line->tokens[p.index];
+    return std::string_view(p.line->text).substr(t.offset, t.length);
+}
+
+TokenStream IncrementalLexer::tokens() const
+{
+    auto owner = std::make_shared<std::string>(source());
+    std::vector<Token> all;
+    all.reserve(tokenTotal);
+
+    std::uint32_t offset = 0;
+    std::uint32_t lineNumber = 1;
+    for (const Chunk& chunk : chunks) {
+        for (const Line& line : chunk.lines) {
+            for (Token t : line.tokens) {
+                t.offset += offset;
+                t.line = lineNumber;
+                all.push_back(t);
+            }
+            offset += static_cast<std::uint32_t>(line.text.size()) + 1;
+            ++lineNumber;
+        }
+    }
+    std::string_view view(*owner);
+    return TokenStream(std::move(owner), view, std::move(all));
+}
+
+std::string IncrementalLexer::source() const
+{
+    std::string out;
+    for (const Chunk& chunk : chunks) {
+        for (const Line& line : chunk.lines) {
+            out += line.text;
+            out += '\n';
+        }
+    }
+    if (!out.empty()) out.pop_back(); // lines are separated, not terminated
+    return out;
+}
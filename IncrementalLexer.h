@@ -0,0 +1,78 @@
+#ifndef INCREMENTALLEXER_H
+#define INCREMENTALLEXER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TokenStream.h"
+
+// Rows of the token buffer touched by one edit
+struct TokenSplice {
+    std::size_t first = 0;    // index of the first replaced token
+    std::size_t removed = 0;  // tokens dropped from the old stream
+    std::size_t inserted = 0; // tokens added in their place
+};
+
+// ===============
+// IncrementalLexer
+// ===============
+// Keeps a document's tokens up to date across edits. Each line owns its
+// text and its tokens, with offsets counted from the start of the line, so
+// the lines after an edit are neither rescanned nor shifted. Lines are held
+// in chunks of a few hundred: an edit touches the lines it replaces, their
+// chunk and the per-chunk index, not the rest of the document.
+class IncrementalLexer
+{
+public:
+    IncrementalLexer();
+
+    // Rescans the whole document.
+    void reset(std::string_view source);
+
+    // Replaces oldLineCount lines starting at firstLine (0-based) with
+    // text, which may itself span several lines (no trailing newline).
+    TokenSplice replaceLines(int firstLine, int oldLineCount, std::string_view text);
+
+    std::size_t tokenCount() const { return tokenTotal; }
+    int lineCount() const { return lineTotal; }
+
+    // Token i with its document line; its offset counts from the start of
+    // that line. O(log chunks + chunk size).
+    Token token(std::size_t i) const;
+    std::string_view text(std::size_t i) const;
+
+    // The whole document as one contiguous stream (a copy)
+    TokenStream tokens() const;
+    std::string source() const;
+
+private:
+    struct Line {
+        std::string text;
+        std::vector<Token> tokens;
+    };
+    struct Chunk {
+        std::vector<Line> lines;
+        std::size_t tokenCount = 0;
+    };
+    struct Position {
+        const Line* line;
+        int lineNumber; // 0-based
+        std::size_t index; // into line->tokens
+    };
+
+    static Line scanLine(std::string_view text);
+    std::size_t chunkOfLine(int line) const;
+    Position locate(std::size_t token) const;
+    void splitChunk(std::size_t c);
+    void reindex();
+
+    std::vector<Chunk> chunks;          // never empty
+    std::vector<std::size_t> chunkTokens; // index of each chunk's first token
+    std::vector<int> chunkLines;        // index of each chunk's first line
+    std::size_t tokenTotal = 0;
+    int lineTotal = 0;
+};
+
+#endif // INCREMENTALLEXER_H
@@ -0,0 +1,90 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// ===============
+// Keywords
+// ===============
+// Keyword recognition through a perfect hash built at compile time. The
+// hash mixes a word's length with its first, second and last character;
+// the seed is searched by the compiler so that no two keywords share a
+// slot. A lookup is one hash, one table load and one compare, whatever
+// the size of the list, so keywords can be added for free.
+namespace KeywordTable {
+
+constexpr std::string_view list[] = {
+    // Control flow used by the sample programs
+    "if", "elif", "else", "for", "while", "def", "return",
+    // The rest of the Python keywords
+    "False", "None", "True", "and", "as", "assert", "async", "await",
+    "break", "class", "continue", "del", "except", "finally", "from",
+    "global", "import", "in", "is", "lambda", "nonlocal", "not", "or",
+    "pass", "raise", "try", "with", "yield",
+};
+constexpr std::size_t count = sizeof(list) / sizeof(list[0]);
+
+constexpr std::size_t bits = 7;
+constexpr std::size_t size = std::size_t(1) << bits;
+
+constexpr std::uint32_t hash(std::string_view w, std::uint32_t seed)
+{
+    std::uint32_t h = seed ^ 2166136261u;
+    h = (h ^ static_cast<std::uint32_t>(w.size())) * 16777619u;
+    h = (h ^ static_cast<unsigned char>(w[0])) * 16777619u;
+    h = (h ^ static_cast<unsigned char>(w[1])) * 16777619u;
+    h = (h ^ static_cast<unsigned char>(w[w.size() - 1])) * 16777619u;
+    return h >> (32 - bits);
+}
+
+struct Table {
+    std::uint32_t seed = 0;
+    std::uint8_t slots[size] = {}; // keyword index + 1, 0 = empty
+    std::size_t minLength = 0;
+    std::size_t maxLength = 0;
+    bool found = false;
+};
+
+constexpr Table build()
+{
+    for (std::uint32_t seed = 0; seed < 100000; ++seed) {
+        Table t;
+        t.seed = seed;
+        t.minLength = list[0].size();
+        bool collision = false;
+        for (std::size_t i = 0; i < count && !collision; ++i) {
+            if (list[i].size() < t.minLength) t.minLength = list[i].size();
+            if (list[i].size() > t.maxLength) t.maxLength = list[i].size();
+            std::uint8_t& slot = t.slots[hash(list[i], seed)];
+            if (slot) collision = true;
+            else slot = static_cast<std::uint8_t>(i + 1);
+        }
+        if (!collision) {
+            t.found = true;
+            return t;
+        }
+    }
+    return Table();
+}
+
+constexpr Table table = build();
+static_assert(table.found, "no collision-free keyword hash seed; raise KeywordTable::bits");
+static_assert(table.minLength >= 2, "the hash reads the second character");
+
+} // namespace KeywordTable
+
+class Keywords
+{
+public:
+    static constexpr bool isKeyword(std::string_view word)
+    {
+        using namespace KeywordTable;
+        if (word.size() < table.minLength || word.size() > table.maxLength) return false;
+        const std::uint8_t slot = table.slots[hash(word, table.seed)];
+        return slot != 0 && list[slot - 1] == word;
+    }
+};
+
+#endif // KEYWORDS_H
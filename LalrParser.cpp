@@ -0,0 +1,174 @@
+#include "LalrParser.h"
+
+#include <string_view>
+
+#include "Grammar.h"
+#include "PdaTrace.h"
+
+namespace {
+
+const char* const kGrammar = R"grammar(
+# Statements; a suite is one simple statement or an indented block
+Program     -> Statements
+Statements  -> Statements Statement | ε
+Statement   -> Simple NEWLINE | Compound
+Simple      -> id = Expression | id AugAssign Expression | Expression | return Expression | return | pass | break | continue
+AugAssign   -> += | -= | *= | /=
+Compound    -> if Expression : Suite ElseClause | while Expression : Suite | for id in Expression : Suite | def id ( Parameters ) : Suite
+ElseClause  -> elif Expression : Suite ElseClause | else : Suite | ε
+Suite       -> Simple NEWLINE | NEWLINE INDENT Block DEDENT
+Block       -> Block Statement | Statement
+Parameters  -> Names | ε
+Names       -> Names , id | id
+
+# Expressions, loosest binding first
+Expression  -> Expression or AndTest | AndTest
+AndTest     -> AndTest and NotTest | NotTest
+NotTest     -> not NotTest | Comparison
+Comparison  -> Comparison CompOp Sum | Sum
+CompOp      -> == | != | < | > | <= | >= | in
+Sum         -> Sum + Term | Sum - Term | Term
+Term        -> Term * Factor | Term / Factor | Term // Factor | Term % Factor | Factor
+Factor      -> - Factor | + Factor | Power
+Power       -> Primary ** Factor | Primary
+Primary     -> Primary ( Arguments ) | Atom
+Atom        -> id | number | True | False | None | ( Expression )
+Arguments   -> ArgList | ε
+ArgList     -> ArgList , Expression | Expression
+)grammar";
+
+struct ParseTables {
+    Grammar grammar;
+    LalrTable lalr;
+    TerminalMap terminal;
+    int newline, indent, dedent;
+
+    explicit ParseTables(Grammar g)
+        : grammar(std::move(g)),
+          lalr(grammar),
+          terminal(grammar),
+          newline(grammar.symbol("NEWLINE")),
+          indent(grammar.symbol("INDENT")),
+          dedent(grammar.symbol("DEDENT"))
+    {
+    }
+};
+
+const ParseTables& parseTables()
+{
+    static const ParseTables tables(Grammar::fromText(kGrammar));
+    return tables;
+}
+
+struct Input {
+    int terminal;
+    int token;   // index of the token it stands for or precedes
+    bool layout; // NEWLINE, INDENT, DEDENT or "$"
+};
+
+// Terminals for the tokens, with Python's layout tokens inserted: NEWLINE
+// ends each logical line, INDENT and DEDENT track its first column
+std::vector<Input> layout(const TokenStream& tokens, const ParseTables& t)
+{
+    std::vector<Input> input;
+    input.reserve(tokens.size() + tokens.size() / 4 + 2);
+    std::vector<std::uint32_t> indents = {1};
+    int brackets = 0;
+    const int n = static_cast<int>(tokens.size());
+    for (int i = 0; i < n; ++i) {
+        const Token& tok = tokens[i];
+        if (brackets == 0 && (i == 0 || tok.line != tokens[i - 1].line)) {
+            if (i > 0) input.push_back({t.newline, i, true});
+            if (tok.column > indents.back()) {
+                indents.push_back(tok.column);
+                input.push_back({t.indent, i, true});
+            }
+            while (tok.column < indents.back()) {
+                indents.pop_back();
+                input.push_back({t.dedent, i, true});
+            }
+            if (tok.column != indents.back()) input.push_back({TerminalMap::Invalid, i, true}); // inconsistent dedent
+        }
+
+        const std::string_view text = tokens.text(tok);
+        if (tok.kind == TokenKind::Delimiter) {
+            if (text == "(" || text == "[" || text == "{") ++brackets;
+            else if ((text == ")" || text == "]" || text == "}") && brackets > 0) --brackets;
+        }
+        input.push_back({t.terminal(tok.kind, text), i, false});
+    }
+    if (n > 0) input.push_back({t.newline, n, true});
+    for (std::size_t d = 1; d < indents.size(); ++d) input.push_back({t.dedent, n, true});
+    input.push_back({Grammar::End, n, true});
+    return input;
+}
+
+} // namespace
+
+// ==========================
+//   LalrParser IMPLEMENTATION
+// ==========================
+
+const Grammar& LalrParser::grammar()
+{
+    return parseTables().grammar;
+}
+
+const LalrTable& LalrParser::table()
+{
+    return parseTables().lalr;
+}
+
+LalrParser::Result LalrParser::parse(const TokenStream& tokens, PdaTrace* trace)
+{
+    const ParseTables& t = parseTables();
+    const Grammar& g = t.grammar;
+    const LalrTable& table = t.lalr;
+    const auto& rules = g.productions();
+
+    const std::vector<Input> input = layout(tokens, t);
+
+    // The stack of LR states; the trace keeps the grammar symbols that
+    // led to them
+    std::vector<int> states = {0};
+    std::uint32_t traceTop = PdaTrace::Empty;
+    if (trace) {
+        trace->begin(g, tokens);
+        traceTop = trace->push(traceTop, Grammar::End);
+    }
+
+    std::size_t i = 0;
+    bool ok = true;
+
+    while (true) {
+        const int cur = input[i].terminal;
+
+        if (trace) trace->step(traceTop, input[i].token, cur, input[i].layout);
+
+        const std::int16_t a = cur == TerminalMap::Invalid ? LalrTable::Error : table.action(states.back(), cur);
+        if (a == LalrTable::Accept) break;
+        if (a == LalrTable::Error) {
+            ok = false;
+            break;
+        }
+        if (a > 0) {
+            states.push_back(a - 1);
+            if (trace) traceTop = trace->push(traceTop, cur);
+            ++i;
+            continue;
+        }
+
+        const auto& p = rules[-a - 1];
+        states.resize(states.size() - (p.last - p.first));
+        states.push_back(table.gotoState(states.back(), p.lhs));
+        if (trace) {
+            for (int k = p.first; k < p.last; ++k) traceTop = trace->pop(traceTop);
+            traceTop = trace->push(traceTop, p.lhs);
+        }
+    }
+
+    Result result;
+    result.accepted = ok;
+    result.position = input[i].token;
+    return result;
+}
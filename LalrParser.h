@@ -0,0 +1,34 @@
+#ifndef LALRPARSER_H
+#define LALRPARSER_H
+
+#include "PdaParser.h"
+#include "TokenStream.h"
+
+class Grammar;
+class LalrTable;
+class PdaTrace;
+
+// ===============
+// LalrParser
+// ===============
+// Shift-reduce parser for the fuller Python-like grammar in LalrParser.cpp
+// (assignments, if/elif/else, while, for, def, calls), driven by a
+// generated LALR(1) table. Token kinds map to terminals: numbers and
+// identifiers by kind, keywords and punctuation by spelling. NEWLINE,
+// INDENT and DEDENT are derived from the tokens' lines and columns as in
+// Python, with lines inside brackets joined.
+class LalrParser
+{
+public:
+    using Result = PdaParser::Result;
+
+    // When trace is given, it records the stack of grammar symbols and the
+    // lookahead before each step, as PdaParser's does
+    static Result parse(const TokenStream& tokens, PdaTrace* trace = nullptr);
+
+    // The grammar and its table, generated on first use
+    static const Grammar& grammar();
+    static const LalrTable& table();
+};
+
+#endif // LALRPARSER_H
@@ -0,0 +1,259 @@
+#include "Lexer.h"
+#include "CharScan.h"
+#include "Keywords.h"
+#include "LexerGenerator.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+// ==========================
+//   Token DFA (scanner)
+// ==========================
+// One transition table covers the whole token set (Tokens.spec, compiled
+// by LexerGenerator), so every character is looked at once and the
+// longest match wins (maximal munch). The table is indexed by byte class
+// and stored in 16-bit entries, which keeps it at a few hundred bytes.
+namespace {
+
+// Self-looping states whose runs are consumed by a CharScan kernel
+enum ScanRun : unsigned char { R_None, R_Identifier, R_Digit };
+
+struct ScanTables {
+    static constexpr std::uint16_t Dead = 0; // DFA state s is row s + 1
+
+    std::array<std::uint8_t, 256> charClass{};
+    int classCount = 0;
+    std::uint16_t start = Dead;
+    std::vector<std::uint16_t> next;  // rows of classCount entries
+    std::vector<std::uint8_t> accept; // per row: 0, or 1 + TokenKind
+    std::vector<std::uint8_t> run;    // per row: ScanRun
+};
+
+ScanTables buildScanTables(const ScannerDFA& scanner)
+{
+    const DFA& dfa = scanner.dfa;
+    ScanTables t;
+    t.charClass = dfa.byteClasses(&t.classCount);
+    t.start = static_cast<std::uint16_t>(dfa.startState + 1);
+
+    const int rows = dfa.stateCount + 1;
+    t.next.assign(static_cast<std::size_t>(rows) * t.classCount, ScanTables::Dead);
+    t.accept.assign(rows, 0);
+    t.run.assign(rows, R_None);
+    for (int s = 0; s < dfa.stateCount; ++s) {
+        for (int c = 0; c < 256; ++c) {
+            std::int32_t target = dfa.step(s, static_cast<unsigned char>(c));
+            t.next[(s + 1) * t.classCount + t.charClass[c]] = static_cast<std::uint16_t>(target + 1);
+        }
+
+        // Rule names are TokenKind names; defaultScanner() rejects others
+        const int rule = scanner.acceptRule[s];
+        if (rule != -1) {
+            TokenKind kind = TokenKind::Unknown;
+            tokenKindFromName(scanner.rules[rule].name, &kind);
+            t.accept[s + 1] = static_cast<std::uint8_t>(kind) + 1;
+        }
+
+        auto loopsOn = [&](CharScan::RunClass k) {
+            for (int c = 0; c < 256; ++c)
+                if (CharScan::matches(k, static_cast<unsigned char>(c)) && dfa.step(s, static_cast<unsigned char>(c)) != s)
+                    return false;
+            return true;
+        };
+        if (loopsOn(CharScan::Identifier)) t.run[s + 1] = R_Identifier;
+        else if (loopsOn(CharScan::Digit)) t.run[s + 1] = R_Digit;
+    }
+    return t;
+}
+
+const ScanTables& scanTables()
+{
+    static const ScanTables tables = buildScanTables(LexerGenerator::defaultScanner());
+    return tables;
+}
+
+// Byte length of the UTF-8 sequence starting with lead byte c
+inline int utf8Length(unsigned char c)
+{
+    if (c < 0xC0) return 1;
+    if (c < 0xE0) return 2;
+    if (c < 0xF0) return 3;
+    return 4;
+}
+
+bool tooLarge(std::string_view source, std::string* error)
+{
+    if (source.size() <= Lexer::kMaxSourceBytes) return false;
+    if (error) *error = "source of " + std::to_string(source.size()) + " bytes is too large to lex (4 GiB at most)";
+    return true;
+}
+
+} // namespace
+
+// ==========================
+//   Lexer IMPLEMENTATION
+// ==========================
+
+TokenStream Lexer::tokenize(std::string source, std::string* error)
+{
+    auto owner = std::make_shared<const std::string>(std::move(source));
+    std::string_view view(*owner);
+    return tokenize(std::move(owner), view, error);
+}
+
+TokenStream Lexer::tokenize(std::shared_ptr<const void> owner, std::string_view source, std::string* error)
+{
+    if (tooLarge(source, error)) return TokenStream();
+
+    std::vector<Token> tokens;
+    // Typical code averages a token every four to five bytes
+    tokens.reserve(source.size() / 4 + 16);
+    scan(source, tokens);
+    tokens.shrink_to_fit();
+    return TokenStream(std::move(owner), source, std::move(tokens));
+}
+
+TokenStream Lexer::tokenize(std::shared_ptr<const void> owner, std::string_view source, ThreadPool& pool,
+                            std::string* error)
+{
+    if (tooLarge(source, error)) return TokenStream();
+
+    // Below this size the fork/join overhead outweighs the scan itself
+    const std::size_t kMinParallelBytes = std::size_t(4) << 20;
+    const std::size_t kMinChunkBytes = std::size_t(1) << 20;
+
+    if (source.size() < kMinParallelBytes || pool.size() < 2)
+        return tokenize(std::move(owner), source, error);
+
+    // Cut at newlines: no token spans one and every line starts in the
+    // scanner's initial state, so each chunk can be lexed on its own.
+    const std::size_t target = std::max(kMinChunkBytes, source.size() / (pool.size() * 4));
+    std::vector<std::size_t> bounds = {0};
+    while (bounds.back() < source.size()) {
+        std::size_t cut = bounds.back() + target;
+        if (cut >= source.size()) {
+            cut = source.size();
+        } else {
+            const void* nl = std::memchr(source.data() + cut, '\n', source.size() - cut);
+            cut = nl ? static_cast<const char*>(nl) - source.data() + 1 : source.size();
+        }
+        bounds.push_back(cut);
+    }
+
+    const std::size_t chunks = bounds.size() - 1;
+    std::vector<std::vector<Token>> parts(chunks);
+    std::vector<std::uint32_t> newlines(chunks);
+    {
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c]() {
+                std::string_view chunk = source.substr(bounds[c], bounds[c + 1] - bounds[c]);
+                parts[c].reserve(chunk.size() / 4 + 16);
+                newlines[c] = scan(chunk, parts[c]);
+            });
+        }
+        group.wait();
+    }
+
+    // Each chunk's tokens land at a known index with known line/offset bases
+    std::vector<std::size_t> firstToken(chunks + 1, 0);
+    std::vector<std::uint32_t> firstLine(chunks, 0);
+    for (std::size_t c = 0; c < chunks; ++c) {
+        firstToken[c + 1] = firstToken[c] + parts[c].size();
+        if (c > 0) firstLine[c] = firstLine[c - 1] + newlines[c - 1];
+    }
+
+    std::vector<Token> tokens(firstToken[chunks]);
+    {
+        TaskGroup group(pool);
+        for (std::size_t c = 0; c < chunks; ++c) {
+            group.run([&, c]() {
+                Token* out = tokens.data() + firstToken[c];
+                const std::uint32_t offset = static_cast<std::uint32_t>(bounds[c]);
+                for (Token t : parts[c]) {
+                    t.offset += offset;
+                    t.line += firstLine[c];
+                    *out++ = t;
+                }
+                std::vector<Token>().swap(parts[c]);
+            });
+        }
+        group.wait();
+    }
+
+    return TokenStream(std::move(owner), source, std::move(tokens));
+}
+
+std::uint32_t Lexer::scan(std::string_view source, std::vector<Token>& tokens)
+{
+    const auto* data = reinterpret_cast<const unsigned char*>(source.data());
+    const size_t n = source.size();
+    const ScanTables& tables = scanTables();
+    const std::uint16_t* next = tables.next.data();
+    const int classCount = tables.classCount;
+
+    std::uint32_t lineNum = 1;
+    std::uint32_t col = 1; // column of data[pos]
+    size_t pos = 0;
+
+    auto addToken = [&](TokenKind kind, size_t start, size_t length) {
+        tokens.push_back({static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(length),
+                          lineNum, col, kind});
+    };
+
+    while (pos < n) {
+        const unsigned char c = data[pos];
+        if (c == '\n') {
+            ++lineNum;
+            col = 1;
+            ++pos;
+            continue;
+        }
+        if (CharScan::matches(CharScan::Space, c)) {
+            const size_t run = CharScan::spaceRun(data + pos, n - pos);
+            col += static_cast<std::uint32_t>(run);
+            pos += run;
+            continue;
+        }
+
+        // Maximal munch: run the DFA until it dies, remember the last accept.
+        std::uint16_t state = tables.start;
+        size_t end = pos;
+        size_t acceptEnd = 0;
+        std::uint8_t acceptKind = 0;
+        while (end < n) {
+            state = next[state * classCount + tables.charClass[data[end]]];
+            if (state == ScanTables::Dead) break;
+            ++end;
+            switch (tables.run[state]) {
+            case R_Identifier: end += CharScan::identifierRun(data + end, n - end); break;
+            case R_Digit:      end += CharScan::digitRun(data + end, n - end); break;
+            }
+            if (tables.accept[state]) {
+                acceptEnd = end;
+                acceptKind = tables.accept[state];
+            }
+        }
+
+        if (acceptKind == 0) {
+            // One character, not one byte, so non-ASCII input keeps its columns
+            size_t length = std::min<size_t>(utf8Length(c), n - pos);
+            addToken(TokenKind::Unknown, pos, length);
+            pos += length;
+            ++col;
+            continue;
+        }
+
+        const size_t length = acceptEnd - pos;
+        TokenKind kind = static_cast<TokenKind>(acceptKind - 1);
+        if (kind == TokenKind::Identifier && Keywords::isKeyword(source.substr(pos, length)))
+            kind = TokenKind::Keyword;
+        addToken(kind, pos, length);
+        pos = acceptEnd;
+        col += static_cast<std::uint32_t>(length);
+    }
+
+    return lineNum - 1;
+}
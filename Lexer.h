@@ -0,0 +1,43 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TokenStream.h"
+
+class ThreadPool;
+
+// ===============
+// Lexer
+// ===============
+class Lexer
+{
+public:
+    // Tokens hold 32-bit offsets, so longer sources are not lexed: tokenize
+    // returns an empty stream and fills error instead.
+    static constexpr std::size_t kMaxSourceBytes = UINT32_MAX;
+
+    // Tokenizes UTF-8 source text. Tokens never span a newline.
+    static TokenStream tokenize(std::string source, std::string* error = nullptr);
+
+    // Zero-copy variant: owner keeps the memory behind source alive
+    // (a std::string, a mapped file, ...) for as long as the stream lives.
+    static TokenStream tokenize(std::shared_ptr<const void> owner, std::string_view source,
+                                std::string* error = nullptr);
+
+    // Parallel variant for large buffers: the source is cut into chunks at
+    // newlines, the chunks are lexed on the pool and their tokens joined.
+    // Produces exactly the same stream as the sequential version.
+    static TokenStream tokenize(std::shared_ptr<const void> owner, std::string_view source, ThreadPool& pool,
+                                std::string* error = nullptr);
+
+    // Appends the tokens of source to out, with lines counted from 1 and
+    // offsets relative to source. Returns the number of newlines seen.
+    static std::uint32_t scan(std::string_view source, std::vector<Token>& out);
+};
+
+#endif // LEXER_H
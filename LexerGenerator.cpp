@@ -0,0 +1,146 @@
+#include "LexerGenerator.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+
+#include "DefaultTokenSpec.h"
+#include "Thompson.h"
+#include "TokenStream.h"
+
+// ==========================
+//   ScannerDFA IMPLEMENTATION
+// ==========================
+
+std::size_t ScannerDFA::longestMatch(std::string_view text, int* rule) const
+{
+    std::size_t length = 0;
+    int matched = -1;
+    if (dfa.stateCount > 0) {
+        std::int32_t state = dfa.startState;
+        if (acceptRule[state] != -1) matched = acceptRule[state];
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            state = dfa.step(state, static_cast<unsigned char>(text[i]));
+            if (state == DFA::Dead) break;
+            if (acceptRule[state] != -1) {
+                length = i + 1;
+                matched = acceptRule[state];
+            }
+        }
+    }
+    if (rule) *rule = matched;
+    return length;
+}
+
+// ==========================
+//   LexerGenerator IMPLEMENTATION
+// ==========================
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Next whitespace-separated field of line, starting at pos
+std::string_view field(std::string_view line, std::size_t& pos)
+{
+    while (pos < line.size() && isSpace(line[pos])) ++pos;
+    std::size_t start = pos;
+    while (pos < line.size() && !isSpace(line[pos])) ++pos;
+    return line.substr(start, pos - start);
+}
+
+} // namespace
+
+std::vector<TokenRule> LexerGenerator::parseSpec(std::string_view text, std::string* error)
+{
+    std::vector<TokenRule> rules;
+    int lineNumber = 0;
+    while (!text.empty()) {
+        std::size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+        ++lineNumber;
+
+        std::size_t pos = 0;
+        std::string_view name = field(line, pos);
+        if (name.empty() || name[0] == '#') continue;
+        std::string_view regex = field(line, pos);
+        std::string_view priority = field(line, pos);
+        std::string_view extra = field(line, pos);
+
+        TokenRule rule{std::string(name), std::string(regex), 0};
+        auto parsed = std::from_chars(priority.data(), priority.data() + priority.size(), rule.priority);
+        if (regex.empty() || !extra.empty() || priority.empty() || parsed.ec != std::errc()
+            || parsed.ptr != priority.data() + priority.size()) {
+            if (error) *error = "line " + std::to_string(lineNumber) + ": expected name, regex and priority";
+            return {};
+        }
+        rules.push_back(std::move(rule));
+    }
+    return rules;
+}
+
+ScannerDFA LexerGenerator::compile(std::vector<TokenRule> rules)
+{
+    ScannerDFA scanner;
+    scanner.rules = std::move(rules);
+
+    // Union of the rule NFAs under one start state; ruleOf marks their accepts
+    NFABuilder combined;
+    const int start = combined.addState();
+    std::vector<int> ruleOf(1, -1);
+    for (std::size_t r = 0; r < scanner.rules.size(); ++r) {
+        NFA nfa = Thompson::fromRegex(scanner.rules[r].regex);
+        const int offset = combined.append(nfa);
+        combined.addEpsilon(start, nfa.startState + offset);
+        for (int s = 0; s < nfa.stateCount(); ++s) ruleOf.push_back(nfa.isAccept(s) ? static_cast<int>(r) : -1);
+    }
+    DFA dfa = SubsetConstruction::determinize(combined.build(start, -1));
+
+    // Each DFA state takes the best rule among the NFA accepts it contains
+    std::vector<int> labels(dfa.stateCount, -1);
+    for (int d = 0; d < dfa.stateCount; ++d) {
+        for (int s : dfa.nfaStates[d]) {
+            const int r = ruleOf[s];
+            if (r == -1) continue;
+            int& best = labels[d];
+            if (best == -1 || scanner.rules[r].priority > scanner.rules[best].priority
+                || (scanner.rules[r].priority == scanner.rules[best].priority && r < best))
+                best = r;
+        }
+    }
+    scanner.dfa = Hopcroft::minimize(dfa, &labels);
+    scanner.acceptRule = std::move(labels);
+    return scanner;
+}
+
+// Tokens.spec is built in, so a malformed line or a rule name that is not
+// a token kind is a build mistake: scanning on with a wrong token set
+// would only hide it
+const ScannerDFA& LexerGenerator::defaultScanner()
+{
+    static const ScannerDFA scanner = [] {
+        std::string error;
+        std::vector<TokenRule> rules = parseSpec(kDefaultTokenSpec, &error);
+        for (const TokenRule& rule : rules) {
+            if (error.empty() && !tokenKindFromName(rule.name, nullptr))
+                error = "rule " + rule.name + ": not a token kind (Number, Identifier, Keyword, Operator, Delimiter, Unknown)";
+        }
+        if (!error.empty()) {
+            std::fprintf(stderr, "Tokens.spec: %s\n", error.c_str());
+            std::abort();
+        }
+        return compile(std::move(rules));
+    }();
+    return scanner;
+}
+
+const TokenRule* LexerGenerator::defaultRule(std::string_view name)
+{
+    for (const auto& rule : defaultScanner().rules)
+        if (rule.name == name) return &rule;
+    return nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef LEXERGENERATOR_H
+#define LEXERGENERATOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Dfa.h"
+
+struct TokenRule {
+    std::string name;
+    std::string regex; // RegexParser syntax
+    int priority = 0;
+};
+
+// ===============
+// ScannerDFA
+// ===============
+// One minimized DFA for a whole token set. Each accepting state names the
+// rule it accepts: among the rules matching there, the highest priority,
+// then the earliest. Minimization never merges states of different rules.
+struct ScannerDFA {
+    std::vector<TokenRule> rules;
+    DFA dfa;
+    std::vector<int> acceptRule; // per state; -1 if not accepting
+
+    // Length of the longest token at the start of text, 0 if there is
+    // none. rule receives the rule it matched, or -1.
+    std::size_t longestMatch(std::string_view text, int* rule) const;
+};
+
+// ===============
+// LexerGenerator
+// ===============
+// Compiles a token spec the way a lexer generator does: a Thompson NFA per
+// rule, their union under a new start state, subset construction and
+// Hopcroft minimization. Scanning costs the same however many rules the
+// spec has.
+class LexerGenerator
+{
+public:
+    // One rule per line: name, regex and priority separated by whitespace.
+    // Blank lines and lines starting with '#' are skipped. On a malformed
+    // line, returns no rules and describes the line in error.
+    static std::vector<TokenRule> parseSpec(std::string_view text, std::string* error = nullptr);
+
+    static ScannerDFA compile(std::vector<TokenRule> rules);
+
+    // Tokens.spec, compiled on first use
+    static const ScannerDFA& defaultScanner();
+    // Rule of the default spec with that name, or nullptr
+    static const TokenRule* defaultRule(std::string_view name);
+};
+
+#endif // LEXERGENERATOR_H
@@ -1,8 +1,9 @@
 #include "LexicalAnalysis.h"
+#include "Lexer.h"
+#include "LexerGenerator.h"
+#include "TokenTableModel.h"
 #include <QFont>
-#include <QTableWidgetItem>
 #include <QHeaderView>
-#include <QRegularExpression>
 #include <QStringList>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -20,177 +21,39 @@
 #include <QGraphicsPathItem>
 #include <QGraphicsPolygonItem>
 #include <QGraphicsTextItem>
-
-// ==========================
-//   Helper Functions
-// ==========================
-
-// A function that builds a simple symbol NFA for a character
-NFA buildSymbolNFA(QChar c)
-{
-    NFA nfa;
-    int s0 = nfa.getNextId();
-    int s1 = nfa.getNextId();
-    nfa.states.append({s0, false});
-    nfa.states.append({s1, true});
-    nfa.transitions.append({s0, QString(c), s1});
-    nfa.startState = s0;
-    nfa.acceptState = s1;
-    return nfa;
-}
-
-// Closure operation: nfa* (Kleene Star)
-NFA buildClosureNFA(const NFA& n)
-{
-    NFA result;
-    int nextId = 0;
-
-    result.states.append({nextId++, false});
-    result.states.append({nextId++, true});
-    int newStart = result.states[0].id;
-    int newAccept = result.states[1].id;
-
-    QMap<int, int> idMap;
-    for (const auto& s : n.states) {
-        idMap[s.id] = nextId++;
-        result.states.append({idMap[s.id], s.isAccept});
-    }
-
-    result.transitions.append({newStart, "ε", idMap[n.startState]});
-    result.transitions.append({newStart, "ε", newAccept});
-
-    for (const auto& s : n.states) {
-        if (s.isAccept) {
-            result.transitions.append({idMap[s.id], "ε", idMap[n.startState]});
-            result.transitions.append({idMap[s.id], "ε", newAccept});
-            for (auto& rs : result.states) {
-                if (rs.id == idMap[s.id]) rs.isAccept = false;
-            }
-        }
-    }
-
-    for (const auto& t : n.transitions) {
-        result.transitions.append({idMap[t.from], t.symbol, idMap[t.to]});
-    }
-
-    result.startState = newStart;
-    result.acceptState = newAccept;
-    return result;
-}
-
-// Concatenation operation: nfa1 + nfa2
-NFA buildConcatNFA(const NFA& n1, const NFA& n2)
-{
-    NFA result = n1;
-    int offset = n1.states.size();
-
-    for (const auto& s : n2.states) {
-        result.states.append({s.id + offset, s.isAccept});
-    }
-
-    for (auto& s : result.states) {
-        if (s.id == n1.acceptState) {
-            s.isAccept = false;
-        }
-    }
-
-    result.transitions.append({n1.acceptState, "ε", n2.startState + offset});
-
-    for (const auto& t : n2.transitions) {
-        result.transitions.append({t.from + offset, t.symbol, t.to + offset});
-    }
-
-    result.acceptState = n2.acceptState + offset;
-    return result;
-}
-
-// Union operation: nfa1 | nfa2
-NFA buildUnionNFA(const NFA& n1, const NFA& n2)
-{
-    NFA result;
-    int nextId = 0;
-
-    result.states.append({nextId++, false});
-    result.states.append({nextId++, true});
-    int newStart = result.states[0].id;
-    int newAccept = result.states[1].id;
-
-    QMap<int, int> idMap;
-    auto addStates = [&](const QList<NFAState>& states) {
-        for (const auto& s : states) {
-            idMap[s.id] = nextId++;
-            result.states.append({idMap[s.id], s.isAccept});
-        }
-    };
-
-    addStates(n1.states);
-    addStates(n2.states);
-
-    result.transitions.append({newStart, "ε", idMap[n1.startState]});
-    result.transitions.append({newStart, "ε", idMap[n2.startState]});
-
-    for (const auto& s : n1.states) {
-        if (s.isAccept) {
-            result.transitions.append({idMap[s.id], "ε", newAccept});
-        }
-    }
-    for (const auto& s : n2.states) {
-        if (s.isAccept) {
-            result.transitions.append({idMap[s.id], "ε", newAccept});
-        }
-    }
-
-    for (const auto& t : n1.transitions) {
-        result.transitions.append({idMap[t.from], t.symbol, idMap[t.to]});
-    }
-    for (const auto& t : n2.transitions) {
-        result.transitions.append({idMap[t.from], t.symbol, idMap[t.to]});
-    }
-
-    result.startState = newStart;
-    result.acceptState = newAccept;
-    return result;
-}
+#include <QTextBlock>
+#include <QTextDocument>
 
 // ==========================
 //   Token-Specific NFA Builder
 // ==========================
 
-// Identifier NFA: Matches [a-zA-Z_][a-zA-Z0-9_]*
-NFA buildIdentifierNFA()
-{
-    NFA first = buildSymbolNFA('a');  // First character: [a-zA-Z_]
-    NFA loop = buildClosureNFA(first); // Loop for subsequent characters: [a-zA-Z0-9_]
-    return loop;
-}
-
-// Number NFA: Matches digits and optional decimal point (e.g., 123, 123.45)
-NFA buildNumberNFA()
+// NFA of a token class as defined in Tokens.spec, or of a lone 'a' for
+// classes the spec does not define
+NFA buildTokenNFA(const QString& tokenType)
 {
-    NFA digit = buildSymbolNFA('0'); // First digit [0-9]
-    NFA dot = buildSymbolNFA('.');   // Decimal point
-    NFA decimal = buildConcatNFA(dot, digit); // Handle decimals like 12.34
-    return buildUnionNFA(digit, decimal);    // Handle integer or decimal numbers
+    const TokenRule* rule = LexerGenerator::defaultRule(tokenType.toStdString());
+    if (!rule) {
+        Thompson t;
+        return t.finish(t.symbol('a')); // Default fallback symbol
+    }
+    return Thompson::fromRegex(rule->regex);
 }
 
 // String Literal NFA: Matches specific string literals (e.g., "Hello")
 NFA buildStringLiteralNFA(const QString& str)
 {
-    NFA nfa;
-    int lastState = nfa.getNextId();
-    nfa.states.append({lastState, false});
-    for (int i = 0; i < str.length(); ++i) {
-        int currentState = nfa.getNextId();
-        nfa.states.append({currentState, false});
-        nfa.transitions.append({lastState, QString(str[i]), currentState});
+    NFABuilder nfa;
+    const int startState = nfa.addState();
+    int lastState = startState;
+    for (char c : str.toUtf8()) {
+        int currentState = nfa.addState();
+        nfa.addEdge(lastState, currentState, static_cast<unsigned char>(c));
         lastState = currentState;
     }
-    int acceptState = nfa.getNextId();
-    nfa.states.append({acceptState, true});
-    nfa.transitions.append({lastState, "ε", acceptState});
-    nfa.startState = nfa.states[0].id;
-    nfa.acceptState = acceptState;
-    return nfa;
+    int acceptState = nfa.addState(true);
+    nfa.addEpsilon(lastState, acceptState);
+    return nfa.build(startState, acceptState);
 }
 
 // ==========================
@@ -254,17 +117,13 @@ DiagramElements DiagramBuilder::buildDynamicDiagram(QGraphicsScene* scene, const
     NFA nfa;
 
     // Dynamically create the NFA based on tokenType
-    if (tokenType == "Identifier") {
-        nfa = buildIdentifierNFA();
-    } else if (tokenType == "Number") {
-        nfa = buildNumberNFA();
-    } else if (tokenType == "String") {
+    if (tokenType == "String") {
         nfa = buildStringLiteralNFA("Print"); // Example string literal
     } else {
-        nfa = buildSymbolNFA('a'); // Default fallback symbol
+        nfa = buildTokenNFA(tokenType);
     }
 
-    if (nfa.states.isEmpty()) {
+    if (nfa.stateCount() == 0) {
         return elements;
     }
 
@@ -276,38 +135,39 @@ DiagramElements DiagramBuilder::buildDynamicDiagram(QGraphicsScene* scene, const
 
     QMap<int, QPointF> statePositions;
     int rows = 3;  // Adjust number of rows based on the number of states
-    int columns = (nfa.states.size() + rows - 1) / rows; // Calculate columns based on number of states
+    int stateCount = nfa.stateCount();
+    int columns = (stateCount + rows - 1) / rows; // Calculate columns based on number of states
 
-    for (int i = 0; i < nfa.states.size(); ++i) {
+    for (int i = 0; i < stateCount; ++i) {
         int row = i / columns;
         int col = i % columns;
 
-        statePositions[nfa.states[i].id] = QPointF(startX + col * stepX, startY + row * stepY);
+        statePositions[i] = QPointF(startX + col * stepX, startY + row * stepY);
     }
 
     // Draw states and transitions
-    for (const auto& state : nfa.states) {
-        QPointF pos = statePositions[state.id];
+    for (int id = 0; id < stateCount; ++id) {
+        QPointF pos = statePositions[id];
         QBrush brush = Qt::white;
 
-        if (state.isAccept) {
+        if (nfa.isAccept(id)) {
             scene->addEllipse(pos.x() - 35, pos.y() - 35, 70, 70, QPen(QColor("#28a745"), 1), Qt::NoBrush);
             brush = QColor("#28a745");
         }
-        if (state.id == nfa.startState) {
+        if (id == nfa.startState) {
             brush = Qt::lightGray;
         }
 
         auto* circle = scene->addEllipse(pos.x() - 30, pos.y() - 30, 60, 60, QPen(Qt::black, 2), brush);
-        auto* text = scene->addText(QString::number(state.id));
+        auto* text = scene->addText(QString::number(id));
         text->setFont(QFont("Arial", 12, QFont::Bold));
         text->setPos(pos.x() - text->boundingRect().width() / 2,
                      pos.y() - text->boundingRect().height() / 2);
-        elements.states[QString::number(state.id)] = circle;
+        elements.states[QString::number(id)] = circle;
     }
 
-    // Draw transitions (arrows)
-    for (const auto& trans : nfa.transitions) {
+    // Draw transitions (arrows); character classes share one arrow
+    for (const auto& trans : mergedEdges(nfa)) {
         if (!statePositions.contains(trans.from) || !statePositions.contains(trans.to)) continue;
 
         QPointF from = statePositions[trans.from];
@@ -323,7 +183,7 @@ DiagramElements DiagramBuilder::buildDynamicDiagram(QGraphicsScene* scene, const
         scene->addLine(to.x(), to.y(), p2.x(), p2.y(), QPen(Qt::black, 2));
 
         QPointF labelPos = from * 0.7 + to * 0.3;
-        auto* label = scene->addText(trans.symbol);
+        auto* label = scene->addText(QString::fromStdString(trans.label));
         label->setFont(QFont("Arial", 10));
         label->setDefaultTextColor(Qt::darkBlue);
         label->setPos(labelPos.x() - label->boundingRect().width() / 2,
@@ -356,6 +216,7 @@ LexicalAnalysisTab::LexicalAnalysisTab(QWidget* parent)
     run->setStyleSheet("background-color: #16163F; color: white;");
     run->setGeometry(leftX + 900 - 70, runY, 70, 30);
     connect(run, &QPushButton::clicked, this, &LexicalAnalysisTab::runLexicalAnalysis);
+    connect(userinput->document(), &QTextDocument::contentsChange, this, &LexicalAnalysisTab::onContentsChange);
 
     int dfaY = runY + 40;
     dfa = new QLabel("DFA Diagram", this);
@@ -381,11 +242,15 @@ LexicalAnalysisTab::LexicalAnalysisTab(QWidget* parent)
     tokenlabel->setFont(QFont("Poppins", 14, QFont::Bold));
     rightLayout->addWidget(tokenlabel);
 
-    tokenizationtable = new QTableWidget(this);
-    tokenizationtable->setColumnCount(4);
-    tokenizationtable->setHorizontalHeaderLabels({"Token", "Type", "Line", "Column"});
+    tokenTableModel = new TokenTableModel(lexer, this);
+
+    tokenizationtable = new QTableView(this);
+    tokenizationtable->setModel(tokenTableModel);
     tokenizationtable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tokenizationtable->setSelectionBehavior(QAbstractItemView::SelectRows);
     tokenizationtable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Fixed row heights keep scrolling O(visible rows) on huge token lists
+    tokenizationtable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     tokenizationtable->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     tokenizationtable->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     rightLayout->addWidget(tokenizationtable);
@@ -399,7 +264,7 @@ LexicalAnalysisTab::LexicalAnalysisTab(QWidget* parent)
     connect(animationTimer, &QTimer::timeout, this, &LexicalAnalysisTab::animateNextStep);
 
     // Connect tokens ready to start animation
-    connect(this, &LexicalAnalysisTab::tokensReady, this, [this](const QList<QStringList>& tokens) {
+    connect(this, &LexicalAnalysisTab::tokensReady, this, [this](const TokenStream& tokens) {
         currentTokens = tokens;
         currentTokenIndex = 0;
         currentStepIndex = 0;
@@ -409,7 +274,7 @@ LexicalAnalysisTab::LexicalAnalysisTab(QWidget* parent)
     });
 
     // Connect table item click to highlight token path
-    connect(tokenizationtable, &QTableWidget::itemClicked, this, &LexicalAnalysisTab::onTokenClicked);
+    connect(tokenizationtable, &QTableView::clicked, this, &LexicalAnalysisTab::onTokenClicked);
 }
 
 void LexicalAnalysisTab::resetHighlighting()
@@ -458,20 +323,20 @@ void LexicalAnalysisTab::highlightTransition(const QList<QGraphicsItem*>& items)
 }
 
 // Handle token click in table
-void LexicalAnalysisTab::onTokenClicked(QTableWidgetItem* item)
+void LexicalAnalysisTab::onTokenClicked(const QModelIndex& index)
 {
-    if (!item) return;
+    if (!index.isValid()) return;
 
     // Stop animation if running
     if (animationTimer->isActive()) {
         animationTimer->stop();
     }
 
-    int row = item->row();
+    int row = index.row();
 
     // Get token and type from the clicked row
-    QString tokenText = tokenizationtable->item(row, 0)->text();
-    QString tokenType = tokenizationtable->item(row, 1)->text();
+    QString tokenText = tokenTableModel->tokenText(row);
+    QString tokenType = tokenTableModel->tokenType(row);
 
     // Reset highlighting first
     resetHighlighting();
@@ -593,16 +458,15 @@ void LexicalAnalysisTab::animateNextStep()
     // Check if we need to load a new token
     if (currentSteps.isEmpty() || currentStepIndex >= currentSteps.size()) {
         // Move to next token
-        if (currentTokenIndex >= currentTokens.size()) {
+        if (currentTokenIndex >= static_cast<int>(currentTokens.size())) {
             animationTimer->stop();
             resetHighlighting();
             return;
         }
 
         // Load next token
-        QStringList token = currentTokens[currentTokenIndex];
-        QString tokenText = token[0];
-        QString tokenType = token[1];
+        QString tokenText = tokenTableModel->tokenText(currentTokenIndex);
+        QString tokenType = tokenTableModel->tokenType(currentTokenIndex);
 
         // Highlight current row in table
         tokenizationtable->selectRow(currentTokenIndex);
@@ -647,121 +511,43 @@ void LexicalAnalysisTab::animateNextStep()
 
 void LexicalAnalysisTab::runLexicalAnalysis()
 {
-    tokenizationtable->setRowCount(0);
-    QString code = userinput->toPlainText();
-    QStringList lines = code.split('\n');
-
-    QRegularExpression numberRegex(R"(^[0-9]+(\.[0-9]+)?)");
-    QRegularExpression identifierRegex(R"(^[a-zA-Z_][a-zA-Z0-9_]*)");
-    QStringList keywords = {"if", "elif", "else", "for", "while" "def", "return"};
-
-    QRegularExpression operatorRegex(
-        R"(^(==|!=|<=|>=|\*\*|//|\+=|-=|\*=|/=|\+|-|\*|/|%|=|<|>))"
-    );
-
-    QRegularExpression delimiterRegex(R"(^[\{\}\(\)\[\]:"'])");
-
-    int row = 0;
-
-    for (int lineNum = 0; lineNum < lines.size(); ++lineNum) {
-        QString line = lines[lineNum];
-        int col = 0;
-
-        while (!line.isEmpty()) {
-            int oldLen = line.length();
-            line = line.trimmed();
-            col += (oldLen - line.length());
-            if (line.isEmpty()) break;
-
-            QRegularExpressionMatch match;
-
-            match = numberRegex.match(line);
-            if (match.hasMatch()) {
-                QString tok = match.captured();
-                tokenizationtable->insertRow(row);
-                tokenizationtable->setItem(row, 0, new QTableWidgetItem(tok));
-                tokenizationtable->setItem(row, 1, new QTableWidgetItem("Number"));
-                tokenizationtable->setItem(row, 2, new QTableWidgetItem(QString::number(lineNum + 1)));
-                tokenizationtable->setItem(row, 3, new QTableWidgetItem(QString::number(col + 1))); // ✅ FIXED: Added Column
-
-                line.remove(0, tok.length());
-                col += tok.length();
-                row++;
-                continue;
-            }
-
-            match = delimiterRegex.match(line);
-            if (match.hasMatch()) {
-                QString tok = match.captured();
-                tokenizationtable->insertRow(row);
-                tokenizationtable->setItem(row, 0, new QTableWidgetItem(tok));
-                tokenizationtable->setItem(row, 1, new QTableWidgetItem("Delimiter"));
-                tokenizationtable->setItem(row, 2, new QTableWidgetItem(QString::number(lineNum + 1)));
-                tokenizationtable->setItem(row, 3, new QTableWidgetItem(QString::number(col + 1))); // ✅ FIXED: Added Column
-
-                line.remove(0, tok.length());
-                col += tok.length();
-                row++;
-                continue;
-            }
-
-            match = operatorRegex.match(line);
-            if (match.hasMatch()) {
-                QString tok = match.captured();
-                tokenizationtable->insertRow(row);
-                tokenizationtable->setItem(row, 0, new QTableWidgetItem(tok));
-                tokenizationtable->setItem(row, 1, new QTableWidgetItem("Operator"));
-                tokenizationtable->setItem(row, 2, new QTableWidgetItem(QString::number(lineNum + 1)));
-                tokenizationtable->setItem(row, 3, new QTableWidgetItem(QString::number(col + 1))); // ✅ FIXED: Added Column
-
-                line.remove(0, tok.length());
-                col += tok.length();
-                row++;
-                continue;
-            }
-
-            match = identifierRegex.match(line);
-            if (match.hasMatch()) {
-                QString tok = match.captured();
-
-                tokenizationtable->insertRow(row);
-                tokenizationtable->setItem(row, 0, new QTableWidgetItem(tok));
-
-                if (keywords.contains(tok))
-                    tokenizationtable->setItem(row, 1, new QTableWidgetItem("Keyword"));
-                else
-                    tokenizationtable->setItem(row, 1, new QTableWidgetItem("Identifier"));
-
-                tokenizationtable->setItem(row, 2, new QTableWidgetItem(QString::number(lineNum + 1)));
-                tokenizationtable->setItem(row, 3, new QTableWidgetItem(QString::number(col + 1))); // ✅ FIXED: Added Column
-
-                line.remove(0, tok.length());
-                col += tok.length();
-                row++;
-                continue;
-            }
-
-            tokenizationtable->insertRow(row);
-            QString unknown = line.left(1);
-            tokenizationtable->setItem(row, 0, new QTableWidgetItem(unknown));
-            tokenizationtable->setItem(row, 1, new QTableWidgetItem("Unknown"));
-            tokenizationtable->setItem(row, 2, new QTableWidgetItem(QString::number(lineNum + 1)));
-            tokenizationtable->setItem(row, 3, new QTableWidgetItem(QString::number(col + 1))); // ✅ FIXED: Added Column
+    // The lexer is already current: onContentsChange keeps it in sync with
+    // every edit, so Run only takes a snapshot and starts the animation.
+    emit tokensReady(lexer.tokens());
+}
 
-            line.remove(0, 1);
-            col += 1;
-            row++;
-        }
+// Re-lexes just the lines an edit touched and splices them into the buffer.
+void LexicalAnalysisTab::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved);
+    QTextDocument* doc = userinput->document();
+    const int newLines = doc->blockCount();
+
+    QTextBlock first = doc->findBlock(position);
+    QTextBlock last = doc->findBlock(position + charsAdded);
+    if (!last.isValid()) last = doc->lastBlock();
+
+    const int firstLine = first.blockNumber();
+    const int replaced = last.blockNumber() - firstLine + 1 - (newLines - documentLines);
+    bool incremental = first.isValid() && lexer.lineCount() == documentLines
+        && replaced >= 1 && firstLine + replaced <= documentLines;
+
+    QString text;
+    for (QTextBlock b = first; incremental; b = b.next()) {
+        QString line = b.text();
+        // Soft line breaks would split a block into several lexer lines
+        if (line.contains(QChar::LineSeparator)) incremental = false;
+        text += line.replace(QChar::Nbsp, QLatin1Char(' '));
+        if (b == last) break;
+        text += QLatin1Char('\n');
     }
 
-    QList<QStringList> tokensList;
-    for (int r = 0; r < tokenizationtable->rowCount(); ++r) {
-        QStringList t;
-        t << tokenizationtable->item(r, 0)->text()
-          << tokenizationtable->item(r, 1)->text()
-          << tokenizationtable->item(r, 2)->text()
-          << tokenizationtable->item(r, 3)->text();
-        tokensList.append(t);
+    if (incremental) {
+        TokenSplice splice = lexer.replaceLines(firstLine, replaced, text.toStdString());
+        tokenTableModel->applySplice(splice);
+    } else {
+        lexer.reset(userinput->toPlainText().toStdString());
+        tokenTableModel->reload();
     }
-    emit tokensReady(tokensList);
+    documentLines = newLines;
 }
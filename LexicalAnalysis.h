@@ -9,34 +9,16 @@
 #include <QList>
 #include <QTimer>
 #include <QLabel>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QTableView>
 #include <QPushButton>
 #include <QTextEdit>
 #include <QStringList>
 
-// ===============
-// NFA Structures
-// ===============
-struct NFAState {
-    int id;
-    bool isAccept = false;
-};
+#include "IncrementalLexer.h"
+#include "Thompson.h"
+#include "TokenStream.h"
 
-struct NFATransition {
-    int from;
-    QString symbol; // "ε" or character
-    int to;
-};
-
-struct NFA {
-    int startState = -1;
-    int acceptState = -1;
-    QList<NFAState> states;
-    QList<NFATransition> transitions;
-    int nextId = 0;
-    int getNextId() { return nextId++; }
-};
+class TokenTableModel;
 
 // ===============
 // Animation Step
@@ -98,12 +80,16 @@ class LexicalAnalysisTab : public QWidget
 public:
     explicit LexicalAnalysisTab(QWidget *parent = nullptr);
 
+    // Token table shared with the Syntax Analysis tab
+    TokenTableModel* tokenModel() const { return tokenTableModel; }
+
 signals:
-    void tokensReady(const QList<QStringList>& tokens);
+    void tokensReady(const TokenStream& tokens);
 private slots:
     void runLexicalAnalysis();
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
     void animateNextStep();
-    void onTokenClicked(QTableWidgetItem* item);
+    void onTokenClicked(const QModelIndex& index);
 
 private:
     QTextEdit* userinput;
@@ -113,9 +99,12 @@ private:
     QGraphicsScene* dfaScene;
     QGraphicsView* dfaView;
     QLabel* tokenlabel;
-    QTableWidget* tokenizationtable;
+    QTableView* tokenizationtable;
+    TokenTableModel* tokenTableModel;
+    IncrementalLexer lexer;
+    int documentLines = 1; // block count the lexer was last synced to
     QTimer* animationTimer;
-    QList<QStringList> currentTokens;
+    TokenStream currentTokens;
     int currentTokenIndex;
     int currentStepIndex;
     QList<AnimationStep> currentSteps;
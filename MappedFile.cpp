@@ -0,0 +1,98 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ==========================
+//   MappedFile IMPLEMENTATION
+// ==========================
+
+#ifdef _WIN32
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path, std::string* error)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        if (error) *error = "cannot open " + path;
+        return nullptr;
+    }
+    file->fileHandle = handle;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        if (error) *error = "cannot stat " + path;
+        return nullptr;
+    }
+    file->length = static_cast<std::size_t>(size.QuadPart);
+    if (file->length == 0) return file; // nothing to map
+
+    file->mappingHandle = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!file->mappingHandle) {
+        if (error) *error = "cannot map " + path;
+        return nullptr;
+    }
+    file->bytes = static_cast<const char*>(MapViewOfFile(file->mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!file->bytes) {
+        if (error) *error = "cannot map " + path;
+        return nullptr;
+    }
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+}
+
+#else
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path, std::string* error)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->length = static_cast<std::size_t>(st.st_size);
+    if (file->length > 0) {
+        void* p = mmap(nullptr, file->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            if (error) *error = path + ": " + std::strerror(errno);
+            ::close(fd);
+            file->length = 0;
+            return nullptr;
+        }
+        madvise(p, file->length, MADV_SEQUENTIAL);
+        file->bytes = static_cast<const char*>(p);
+    }
+    ::close(fd); // the mapping stays valid without the descriptor
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+    if (bytes) munmap(const_cast<char*>(bytes), length);
+}
+
+#endif
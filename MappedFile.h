@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+// ===============
+// MappedFile
+// ===============
+// Read-only memory mapping of a whole file. Hand the shared pointer to
+// Lexer::tokenize as the owner to lex the file without copying it.
+class MappedFile
+{
+public:
+    // Returns nullptr and fills error if the file cannot be mapped.
+    static std::shared_ptr<const MappedFile> open(const std::string& path, std::string* error = nullptr);
+
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view data() const { return std::string_view(bytes, length); }
+
+private:
+    MappedFile() = default;
+
+    const char* bytes = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
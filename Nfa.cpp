@@ -0,0 +1,135 @@
+#include "Nfa.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+const char* const kEpsilon = "ε";
+
+std::string edgeLabel(const NFAEdge& edge)
+{
+    if (edge.epsilon) return kEpsilon;
+    if (edge.symbol >= 0x20 && edge.symbol < 0x7F) return std::string(1, static_cast<char>(edge.symbol));
+    char escaped[8];
+    std::snprintf(escaped, sizeof(escaped), "\\x%02X", edge.symbol);
+    return escaped;
+}
+
+std::string byteSetLabel(std::vector<unsigned char> bytes)
+{
+    std::sort(bytes.begin(), bytes.end());
+    bytes.erase(std::unique(bytes.begin(), bytes.end()), bytes.end());
+
+    std::string label;
+    for (std::size_t i = 0; i < bytes.size();) {
+        std::size_t j = i;
+        while (j + 1 < bytes.size() && bytes[j + 1] == bytes[j] + 1) ++j;
+        if (!label.empty()) label += ',';
+        label += edgeLabel({0, bytes[i], false});
+        if (j - i >= 2) label += '-' + edgeLabel({0, bytes[j], false});
+        else if (j > i) label += ',' + edgeLabel({0, bytes[j], false});
+        i = j + 1;
+    }
+    return label;
+}
+
+std::vector<LabelledEdge> mergedEdges(const NFA& nfa)
+{
+    std::vector<LabelledEdge> merged;
+    std::map<int, std::pair<bool, std::vector<unsigned char>>> byTarget;
+    for (int s = 0; s < nfa.stateCount(); ++s) {
+        byTarget.clear();
+        for (const auto& e : nfa.out(s)) {
+            auto& [epsilon, bytes] = byTarget[e.to];
+            if (e.epsilon) epsilon = true;
+            else bytes.push_back(e.symbol);
+        }
+        for (auto& [to, symbols] : byTarget) {
+            std::string label = symbols.first ? kEpsilon : "";
+            if (!symbols.second.empty()) {
+                if (!label.empty()) label += ',';
+                label += byteSetLabel(std::move(symbols.second));
+            }
+            merged.push_back({s, to, std::move(label)});
+        }
+    }
+    return merged;
+}
+
+// ==========================
+//   NFABuilder IMPLEMENTATION
+// ==========================
+
+void NFABuilder::reserve(std::size_t states, std::size_t edges)
+{
+    accepting.reserve(states);
+    pending.reserve(edges);
+}
+
+int NFABuilder::addState(bool accept)
+{
+    accepting.push_back(accept ? 1 : 0);
+    return static_cast<int>(accepting.size()) - 1;
+}
+
+void NFABuilder::setAccept(int state, bool accept)
+{
+    accepting[state] = accept ? 1 : 0;
+}
+
+int NFABuilder::addEdge(int from, int to, unsigned char symbol)
+{
+    pending.push_back({from, {to, symbol, false}});
+    return static_cast<int>(pending.size()) - 1;
+}
+
+int NFABuilder::addEpsilon(int from, int to)
+{
+    pending.push_back({from, {to, 0, true}});
+    return static_cast<int>(pending.size()) - 1;
+}
+
+int NFABuilder::addSave(int from, int to, int slot)
+{
+    return add(from, {to, 0, true, static_cast<std::int16_t>(slot)});
+}
+
+int NFABuilder::add(int from, const NFAEdge& edge)
+{
+    if (edge.save >= 0) captureCount = std::max(captureCount, edge.save / 2 + 1);
+    pending.push_back({from, edge});
+    return static_cast<int>(pending.size()) - 1;
+}
+
+int NFABuilder::append(const NFA& nfa)
+{
+    const int offset = stateCount();
+    accepting.insert(accepting.end(), nfa.accepting.begin(), nfa.accepting.end());
+    for (int s = 0; s < nfa.stateCount(); ++s) {
+        for (const auto& e : nfa.out(s)) {
+            NFAEdge moved = e;
+            moved.to += offset;
+            add(s + offset, moved);
+        }
+    }
+    return offset;
+}
+
+NFA NFABuilder::build(int startState, int acceptState) const
+{
+    NFA nfa;
+    nfa.startState = startState;
+    nfa.acceptState = acceptState;
+    nfa.captureCount = captureCount;
+    nfa.accepting = accepting;
+
+    // Counting sort by source state keeps each state's edges in insertion order
+    nfa.offsets.assign(accepting.size() + 1, 0);
+    for (const auto& p : pending) ++nfa.offsets[p.from + 1];
+    for (std::size_t s = 0; s < accepting.size(); ++s) nfa.offsets[s + 1] += nfa.offsets[s];
+
+    nfa.edges.resize(pending.size());
+    std::vector<std::uint32_t> fill(nfa.offsets.begin(), nfa.offsets.end() - 1);
+    for (const auto& p : pending) nfa.edges[fill[p.from]++] = p.edge;
+    return nfa;
+}
@@ -0,0 +1,105 @@
+#ifndef NFA_H
+#define NFA_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Display form of an ε-transition
+extern const char* const kEpsilon;
+
+// ===============
+// NFA
+// ===============
+// The automaton type shared by the Thompson construction, the determinizers
+// and the diagrams. States are dense IDs 0..stateCount()-1; symbols are
+// bytes, with ε-transitions flagged instead of spelled as a symbol. Out-edges
+// are stored in compressed sparse rows: the edges of state s are
+// edges[offsets[s]] .. edges[offsets[s + 1] - 1], in insertion order, which
+// is also their priority for the Pike VM.
+struct NFAEdge {
+    std::int32_t to;
+    std::uint8_t symbol; // unused when epsilon
+    bool epsilon;
+    std::int16_t save = -1; // ε only: capture slot that records the position
+};
+
+struct NFA {
+    struct EdgeRange {
+        const NFAEdge* first;
+        const NFAEdge* last;
+        const NFAEdge* begin() const { return first; }
+        const NFAEdge* end() const { return last; }
+        std::size_t size() const { return static_cast<std::size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    int startState = 0;
+    int acceptState = 0; // -1 when no state is reachable and accepting
+    int captureCount = 0;                  // groups; slots 2g and 2g + 1
+    std::vector<std::uint8_t> accepting;   // per state
+    std::vector<std::uint32_t> offsets{0}; // stateCount() + 1 entries
+    std::vector<NFAEdge> edges;
+
+    int stateCount() const { return static_cast<int>(accepting.size()); }
+    bool isAccept(int state) const { return accepting[state] != 0; }
+    EdgeRange out(int state) const
+    {
+        return {edges.data() + offsets[state], edges.data() + offsets[state + 1]};
+    }
+};
+
+// "ε" or the symbol as text (non-printable bytes as \xNN)
+std::string edgeLabel(const NFAEdge& edge);
+
+// Label for several parallel edges, with runs written as ranges: "0-9,_"
+std::string byteSetLabel(std::vector<unsigned char> bytes);
+
+// Edges for drawing: one per (from, to) pair, parallel edges merged into a
+// single label such as "ε", "a" or "0-9,_"
+struct LabelledEdge {
+    int from;
+    int to;
+    std::string label;
+};
+std::vector<LabelledEdge> mergedEdges(const NFA& nfa);
+
+// ===============
+// NFABuilder
+// ===============
+// Collects states and edges in any order; build() lays the edges out in
+// CSR form with a counting sort, O(states + edges). Edges are numbered in
+// insertion order and their targets may be set later (see Thompson).
+class NFABuilder
+{
+public:
+    void reserve(std::size_t states, std::size_t edges);
+
+    int addState(bool accept = false);
+    void setAccept(int state, bool accept);
+    int addEdge(int from, int to, unsigned char symbol);
+    int addEpsilon(int from, int to);
+    int addSave(int from, int to, int slot); // ε that records a capture slot
+    int add(int from, const NFAEdge& edge);
+
+    std::int32_t target(int edge) const { return pending[edge].edge.to; }
+    void setTarget(int edge, std::int32_t to) { pending[edge].edge.to = to; }
+
+    // Copies nfa's states and edges; returns the offset added to its IDs
+    int append(const NFA& nfa);
+
+    int stateCount() const { return static_cast<int>(accepting.size()); }
+    NFA build(int startState, int acceptState) const;
+
+private:
+    struct PendingEdge {
+        std::int32_t from;
+        NFAEdge edge;
+    };
+
+    std::vector<std::uint8_t> accepting;
+    std::vector<PendingEdge> pending;
+    int captureCount = 0;
+};
+
+#endif // NFA_H
@@ -0,0 +1,146 @@
+#include "PdaParser.h"
+
+#include "Grammar.h"
+#include "PdaTrace.h"
+
+namespace {
+
+// The statement grammar as data. Statement is left-factored on id so one
+// token of lookahead separates assignments from expression statements.
+const char* const kGrammar = R"grammar(
+Program    -> Statement Program | ε
+Statement  -> id IdTail | Operand TermRest ExprRest
+IdTail     -> = Expression | TermRest ExprRest
+Expression -> Term ExprRest
+ExprRest   -> + Term ExprRest | - Term ExprRest | ε
+Term       -> Factor TermRest
+TermRest   -> * Factor TermRest | / Factor TermRest | // Factor TermRest | % Factor TermRest | ** Factor TermRest | ε
+Factor     -> id | Operand
+Operand    -> ( Expression ) | number | True | False | None
+)grammar";
+
+struct ParseTables {
+    Grammar grammar;
+    LL1Table ll1;
+    TerminalMap terminal;
+
+    explicit ParseTables(Grammar g) : grammar(std::move(g)), ll1(grammar), terminal(grammar) {}
+};
+
+const ParseTables& parseTables()
+{
+    static const ParseTables tables(Grammar::fromText(kGrammar));
+    return tables;
+}
+
+} // namespace
+
+// ==========================
+//   PdaParser IMPLEMENTATION
+// ==========================
+
+PdaParser::Result PdaParser::parse(const TokenStream& tokens, PdaTrace* trace)
+{
+    const ParseTables& t = parseTables();
+    const Grammar& g = t.grammar;
+    const auto& rules = g.productions();
+    const auto& rhs = g.rhsSymbols();
+    const std::size_t n = tokens.size();
+
+    // The token's terminal, or the end marker past the last token
+    auto terminalAt = [&](std::size_t i) {
+        return i < n ? t.terminal(tokens[i].kind, tokens.text(i)) : Grammar::End;
+    };
+
+    // The trace mirrors the stack in its persistent form
+    std::vector<int> stack;
+    std::uint32_t traceTop = PdaTrace::Empty;
+    auto push = [&](int symbol) {
+        stack.push_back(symbol);
+        if (trace) traceTop = trace->push(traceTop, symbol);
+    };
+    auto pop = [&]() {
+        stack.pop_back();
+        if (trace) traceTop = trace->pop(traceTop);
+    };
+
+    if (trace) trace->begin(g, tokens);
+    push(Grammar::End);
+    push(g.startSymbol());
+
+    std::size_t i = 0;
+    int cur = terminalAt(0);
+    bool ok = true;
+
+    while (ok) {
+        const int top = stack.back();
+
+        if (trace) trace->step(traceTop, i, cur, i == n);
+
+        if (top == Grammar::End && cur == Grammar::End) break;
+
+        if (g.isTerminal(top)) {
+            ok = top == cur;
+            if (ok) {
+                pop();
+                cur = terminalAt(++i);
+            }
+            continue;
+        }
+
+        const int p = cur == TerminalMap::Invalid ? LL1Table::Error : t.ll1.production(top, cur);
+        if (p == LL1Table::Error) {
+            ok = false;
+            continue;
+        }
+        pop();
+        for (int k = rules[p].last; k > rules[p].first; --k) push(rhs[k - 1]);
+    }
+
+    Result result;
+    result.accepted = ok;
+    result.position = static_cast<int>(i);
+    return result;
+}
+
+PdaParser::Result PdaParser::validate(const TokenStream& tokens)
+{
+    const ParseTables& t = parseTables();
+    const Grammar::Production* rules = t.grammar.productions().data();
+    const int* rhs = t.grammar.rhsSymbols().data();
+    const int terminals = t.grammar.terminalCount();
+    const std::size_t n = tokens.size();
+
+    std::int16_t stack[MaxDepth];
+    int depth = 0;
+    stack[depth++] = Grammar::End;
+    stack[depth++] = static_cast<std::int16_t>(t.grammar.startSymbol());
+
+    Result result;
+    std::size_t i = 0;
+    int cur = n ? t.terminal(tokens[0].kind, tokens.text(0)) : Grammar::End;
+    while (true) {
+        const int top = stack[depth - 1];
+        if (top < terminals) {
+            if (top != cur) break;
+            if (cur == Grammar::End) {
+                result.accepted = true;
+                break;
+            }
+            --depth;
+            ++i;
+            cur = i < n ? t.terminal(tokens[i].kind, tokens.text(i)) : Grammar::End;
+            continue;
+        }
+
+        const int p = cur == TerminalMap::Invalid ? LL1Table::Error : t.ll1.production(top, cur);
+        if (p == LL1Table::Error) break;
+        const Grammar::Production& rule = rules[p];
+        if (depth - 1 + (rule.last - rule.first) > MaxDepth) break;
+        --depth;
+        for (int k = rule.last; k > rule.first; --k) stack[depth++] = static_cast<std::int16_t>(rhs[k - 1]);
+    }
+
+    result.position = static_cast<int>(i);
+    return result;
+}
@@ -0,0 +1,46 @@
+#ifndef PDAPARSER_H
+#define PDAPARSER_H
+
+#include "TokenStream.h"
+
+class PdaTrace;
+
+// ===============
+// PdaParser
+// ===============
+// Table-driven predictive pushdown automaton for the Python-like statement
+// grammar. The grammar is data (see PdaParser.cpp); its LL(1) table is
+// computed once and the driver only indexes table[nonterminal][terminal].
+// Tokens map to terminals by their lexer kind (see TerminalMap):
+//
+//   Program    -> Statement Program | ε
+//   Statement  -> id IdTail | Operand TermRest ExprRest
+//   IdTail     -> = Expression | TermRest ExprRest
+//   Expression -> Term ExprRest
+//   ExprRest   -> (+|-) Term ExprRest | ε
+//   Term       -> Factor TermRest
+//   TermRest   -> (*|/|//|%|**) Factor TermRest | ε
+//   Factor     -> id | Operand
+//   Operand    -> ( Expression ) | number | True | False | None
+class PdaParser
+{
+public:
+    struct Result {
+        bool accepted = false;
+        int position = 0; // index of the token the PDA stopped on
+    };
+
+    // Symbols the validating stack holds
+    static constexpr int MaxDepth = 4096;
+
+    // Parses the lexer's tokens; the end marker "$" follows the last one.
+    // When trace is given, it is restarted and records every step.
+    static Result parse(const TokenStream& tokens, PdaTrace* trace = nullptr);
+
+    // Same verdict without a trace, for batch use: the stack is a fixed
+    // array of MaxDepth symbols, so no step allocates. Input nested deeper
+    // than that is rejected at the token where the stack would overflow.
+    static Result validate(const TokenStream& tokens);
+};
+
+#endif // PDAPARSER_H
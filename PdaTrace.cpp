@@ -0,0 +1,54 @@
+#include "PdaTrace.h"
+
+#include <algorithm>
+
+#include "Grammar.h"
+
+// ==========================
+//   PdaTrace IMPLEMENTATION
+// ==========================
+
+void PdaTrace::begin(const Grammar& g, const TokenStream& input)
+{
+    grammar = &g;
+    tokens = input;
+    nodes.clear();
+    steps.clear();
+}
+
+std::uint32_t PdaTrace::push(std::uint32_t top, int symbol)
+{
+    nodes.push_back({top, static_cast<std::int16_t>(symbol)});
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+}
+
+void PdaTrace::step(std::uint32_t top, std::size_t token, int lookahead, bool layout)
+{
+    steps.push_back({top, static_cast<std::uint32_t>(token), static_cast<std::int16_t>(lookahead), layout});
+}
+
+std::vector<int> PdaTrace::stack(std::size_t step) const
+{
+    std::vector<int> symbols;
+    for (std::uint32_t n = steps[step].top; n != Empty; n = nodes[n].below) symbols.push_back(nodes[n].symbol);
+    std::reverse(symbols.begin(), symbols.end());
+    return symbols;
+}
+
+std::string PdaTrace::line(std::size_t step) const
+{
+    std::string out = "STACK:";
+    for (int symbol : stack(step)) out += ' ' + grammar->name(symbol);
+
+    const Step& s = steps[step];
+    out += " | INPUT: ";
+    if (!s.layout) out += tokens.text(s.token);
+    else if (s.lookahead >= 0) out += grammar->name(s.lookahead);
+    else out += '?';
+    return out;
+}
+
+std::size_t PdaTrace::bytes() const
+{
+    return nodes.capacity() * sizeof(Node) + steps.capacity() * sizeof(Step);
+}
@@ -0,0 +1,63 @@
+#ifndef PDATRACE_H
+#define PDATRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TokenStream.h"
+
+class Grammar;
+
+// ===============
+// PdaTrace
+// ===============
+// A parser run recorded in a few bytes per step. The stack is persistent:
+// a push appends a node pointing at the node below it and a pop moves to
+// that node, so a step stores only its top node and lookahead (12 bytes,
+// plus 8 per push). Any step's stack is rebuilt in O(depth) by walking
+// down from its top, and trace lines are only formatted when asked for.
+class PdaTrace
+{
+public:
+    static constexpr std::uint32_t Empty = 0xFFFFFFFF; // the empty stack
+
+    // Clears the trace for a run of a parser for grammar over tokens; the
+    // grammar must outlive the trace
+    void begin(const Grammar& grammar, const TokenStream& tokens);
+
+    // Recording: new tops after a push or pop of the stack at top
+    std::uint32_t push(std::uint32_t top, int symbol);
+    std::uint32_t pop(std::uint32_t top) const { return nodes[top].below; }
+
+    // The parser is about to act on stack top with lookahead terminal at
+    // token. Layout lookaheads ("$", NEWLINE, ...) show their terminal name
+    // instead of the token's text.
+    void step(std::uint32_t top, std::size_t token, int lookahead, bool layout);
+
+    std::size_t stepCount() const { return steps.size(); }
+    std::size_t tokenAt(std::size_t step) const { return steps[step].token; }
+    std::vector<int> stack(std::size_t step) const; // bottom first
+    std::string line(std::size_t step) const;       // "STACK: ... | INPUT: ..."
+    std::size_t bytes() const;                      // memory held by the record
+
+private:
+    struct Node {
+        std::uint32_t below;
+        std::int16_t symbol;
+    };
+    struct Step {
+        std::uint32_t top;
+        std::uint32_t token;
+        std::int16_t lookahead;
+        bool layout;
+    };
+
+    const Grammar* grammar = nullptr;
+    TokenStream tokens;
+    std::vector<Node> nodes;
+    std::vector<Step> steps;
+};
+
+#endif // PDATRACE_H
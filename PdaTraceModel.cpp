@@ -0,0 +1,30 @@
+#include "PdaTraceModel.h"
+
+PdaTraceModel::PdaTraceModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void PdaTraceModel::setTrace(PdaTrace trace)
+{
+    beginResetModel();
+    record = std::move(trace);
+    endResetModel();
+}
+
+void PdaTraceModel::clear()
+{
+    setTrace(PdaTrace());
+}
+
+int PdaTraceModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(record.stepCount());
+}
+
+QVariant PdaTraceModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    if (role != Qt::DisplayRole) return QVariant();
+    return QString::number(index.row()) + QStringLiteral("  ") + QString::fromStdString(record.line(index.row()));
+}
@@ -0,0 +1,32 @@
+#ifndef PDATRACEMODEL_H
+#define PDATRACEMODEL_H
+
+#include <QAbstractListModel>
+
+#include "PdaTrace.h"
+
+// ===============
+// PdaTraceModel
+// ===============
+// One row per recorded parser step. Rows are formatted on demand from the
+// persistent trace, so a view only rebuilds the stacks it paints.
+class PdaTraceModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit PdaTraceModel(QObject* parent = nullptr);
+
+    // Takes the trace over; rows are numbered from step 0
+    void setTrace(PdaTrace trace);
+    void clear();
+    const PdaTrace& trace() const { return record; }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    PdaTrace record;
+};
+
+#endif // PDATRACEMODEL_H
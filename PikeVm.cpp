@@ -0,0 +1,166 @@
+#include "PikeVm.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// ==========================
+//   PikeVM IMPLEMENTATION
+// ==========================
+
+namespace {
+
+// Threads of one step in priority order: the state of each and its slots,
+// 2 per capture group plus the offset the thread started at.
+struct ThreadList {
+    std::vector<int> states;
+    std::vector<std::ptrdiff_t> slots;
+    std::size_t count = 0;
+};
+
+class Simulation
+{
+public:
+    explicit Simulation(const NFA& nfa)
+        : nfa(nfa),
+          width(2 * nfa.captureCount + 1),
+          mark(nfa.stateCount(), 0),
+          important(nfa.stateCount(), 0),
+          scratch(width, -1)
+    {
+        for (int s = 0; s < nfa.stateCount(); ++s) {
+            bool hasSymbol = false;
+            for (const auto& e : nfa.out(s)) hasSymbol |= !e.epsilon;
+            important[s] = hasSymbol || nfa.isAccept(s);
+        }
+        for (ThreadList* list : {&current, &next}) {
+            list->states.resize(nfa.stateCount());
+            list->slots.resize(nfa.stateCount() * width);
+        }
+        stack.reserve(2 * nfa.edges.size() + 1);
+    }
+
+    RegexMatch run(std::string_view text, bool anchored)
+    {
+        RegexMatch best;
+        std::vector<std::ptrdiff_t> captured(width, -1); // slots of the best match
+
+        ++generation;
+        startThread(current, 0);
+        for (std::size_t pos = 0;; ++pos) {
+            // The first accepting thread of a step has the highest priority
+            for (std::size_t t = 0; t < current.count; ++t) {
+                if (!nfa.isAccept(current.states[t])) continue;
+                const std::ptrdiff_t* slots = &current.slots[t * width];
+                std::size_t start = static_cast<std::size_t>(slots[width - 1]);
+                if (best.found && (start > best.start || (start == best.start && pos <= best.end))) continue;
+                best.found = true;
+                best.start = start;
+                best.end = pos;
+                std::copy(slots, slots + width, captured.begin());
+            }
+            if (pos == text.size()) break;
+
+            // A thread that started after the best match can only do worse
+            ++generation;
+            next.count = 0;
+            const unsigned char c = static_cast<unsigned char>(text[pos]);
+            for (std::size_t t = 0; t < current.count; ++t) {
+                const std::ptrdiff_t* slots = &current.slots[t * width];
+                if (best.found && static_cast<std::size_t>(slots[width - 1]) > best.start) continue;
+                for (const auto& e : nfa.out(current.states[t])) {
+                    if (e.epsilon || e.symbol != c) continue;
+                    std::copy(slots, slots + width, scratch.begin());
+                    addThread(next, e.to, pos + 1);
+                }
+            }
+            if (!anchored && !best.found) startThread(next, pos + 1);
+            std::swap(current, next);
+            if (current.count == 0) break;
+        }
+
+        if (best.found) {
+            best.groups.resize(nfa.captureCount);
+            for (int g = 0; g < nfa.captureCount; ++g) {
+                std::ptrdiff_t from = captured[2 * g], to = captured[2 * g + 1];
+                best.groups[g] = (from < 0 || to < 0) ? std::make_pair(std::ptrdiff_t(-1), std::ptrdiff_t(-1))
+                                                      : std::make_pair(from, to);
+            }
+        }
+        return best;
+    }
+
+private:
+    // A pending visit, or a slot value to put back once a save edge's
+    // subtree has been explored
+    struct Frame {
+        enum Kind : std::uint8_t { Visit, Save, Restore } kind;
+        std::int32_t state;
+        std::int32_t slot;
+        std::ptrdiff_t value;
+    };
+
+    void startThread(ThreadList& list, std::size_t pos)
+    {
+        std::fill(scratch.begin(), scratch.end(), -1);
+        scratch[width - 1] = static_cast<std::ptrdiff_t>(pos);
+        addThread(list, nfa.startState, pos);
+    }
+
+    // Follows ε-edges from state depth-first in edge order, adding a thread
+    // with the current scratch slots for each state not yet in this step
+    void addThread(ThreadList& list, int state, std::size_t pos)
+    {
+        stack.push_back({Frame::Visit, state, 0, 0});
+        while (!stack.empty()) {
+            Frame f = stack.back();
+            stack.pop_back();
+            if (f.kind == Frame::Restore) {
+                scratch[f.slot] = f.value;
+                continue;
+            }
+            if (f.kind == Frame::Save) {
+                stack.push_back({Frame::Restore, 0, f.slot, scratch[f.slot]});
+                scratch[f.slot] = static_cast<std::ptrdiff_t>(pos);
+            }
+            const int s = f.state;
+            if (mark[s] == generation) continue;
+            mark[s] = generation;
+
+            if (important[s]) {
+                list.states[list.count] = s;
+                std::copy(scratch.begin(), scratch.end(), list.slots.begin() + list.count * width);
+                ++list.count;
+            }
+            auto out = nfa.out(s);
+            for (auto e = out.end(); e != out.begin();) {
+                --e;
+                if (!e->epsilon) continue;
+                if (e->save >= 0) stack.push_back({Frame::Save, e->to, e->save, 0});
+                else stack.push_back({Frame::Visit, e->to, 0, 0});
+            }
+        }
+    }
+
+    const NFA& nfa;
+    const std::size_t width;
+    std::vector<std::uint32_t> mark; // generation that last added the state
+    std::vector<std::uint8_t> important;
+    std::vector<std::ptrdiff_t> scratch;
+    std::vector<Frame> stack;
+    ThreadList current, next;
+    std::uint32_t generation = 0;
+};
+
+} // namespace
+
+RegexMatch PikeVM::search(const NFA& nfa, std::string_view text)
+{
+    return Simulation(nfa).run(text, false);
+}
+
+RegexMatch PikeVM::matchWhole(const NFA& nfa, std::string_view text)
+{
+    RegexMatch match = Simulation(nfa).run(text, true);
+    if (match.found && match.end != text.size()) return RegexMatch();
+    return match;
+}
@@ -0,0 +1,41 @@
+#ifndef PIKEVM_H
+#define PIKEVM_H
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Nfa.h"
+
+// ===============
+// RegexMatch
+// ===============
+struct RegexMatch {
+    bool found = false;
+    std::size_t start = 0;
+    std::size_t end = 0;
+    // Span of each capture group; {-1, -1} if it took no part in the match
+    std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t>> groups;
+};
+
+// ===============
+// PikeVM
+// ===============
+// Pike's simulation of an NFA: threads advance over the input in lockstep,
+// at most one per NFA state, each carrying its own capture slots. When two
+// threads reach a state the one that got there first (earlier start, then
+// earlier edge) wins, so a search costs O(n * m) for n bytes and m states
+// without backtracking, whatever the pattern.
+class PikeVM
+{
+public:
+    // Leftmost-longest match anywhere in text; captures follow the
+    // highest-priority path to it.
+    static RegexMatch search(const NFA& nfa, std::string_view text);
+
+    // Match of the whole text, with its captures
+    static RegexMatch matchWhole(const NFA& nfa, std::string_view text);
+};
+
+#endif // PIKEVM_H
@@ -0,0 +1,99 @@
+#include "RegexCache.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// The most recently used patterns, newest first. Every keystroke in the
+// Thompson tab compiles a new prefix, so old entries must fall out.
+template <class Compiled>
+class RecentPatterns
+{
+public:
+    using Entry = std::shared_ptr<const Compiled>;
+
+    Entry find(const std::string& pattern)
+    {
+        auto it = index.find(pattern);
+        if (it == index.end()) return nullptr;
+        order.splice(order.begin(), order, it->second);
+        return *it->second;
+    }
+
+    // Keeps an entry already inserted by another thread
+    Entry insert(Entry compiled)
+    {
+        if (Entry existing = find(compiled->pattern)) return existing;
+        order.push_front(std::move(compiled));
+        index.emplace(order.front()->pattern, order.begin());
+        if (order.size() > static_cast<std::size_t>(RegexCache::kCacheEntries)) {
+            index.erase(order.back()->pattern);
+            order.pop_back();
+        }
+        return order.front();
+    }
+
+    void clear()
+    {
+        index.clear();
+        order.clear();
+    }
+
+private:
+    std::list<Entry> order;
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> index;
+};
+
+std::mutex cacheMutex;
+RecentPatterns<CompiledRegex> cache;
+RecentPatterns<CompiledDerivatives> derivativeCache;
+
+} // namespace
+
+// ==========================
+//   RegexCache IMPLEMENTATION
+// ==========================
+
+std::shared_ptr<const CompiledRegex> RegexCache::get(const std::string& pattern)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (auto compiled = cache.find(pattern)) return compiled;
+    }
+
+    // Compile outside the lock; if two threads race, the first insert wins
+    auto compiled = std::make_shared<CompiledRegex>();
+    compiled->pattern = pattern;
+    compiled->nfa = Thompson::fromRegex(pattern, &compiled->steps);
+    compiled->dfa = SubsetConstruction::determinize(compiled->nfa, kDfaStateLimit);
+    compiled->minimal = Hopcroft::minimize(compiled->dfa);
+    compiled->packed = PackedDFA(compiled->minimal);
+    compiled->bitParallel = BitParallelMatcher::compile(compiled->nfa);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cache.insert(std::move(compiled));
+}
+
+std::shared_ptr<const CompiledDerivatives> RegexCache::derivatives(const std::string& pattern)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (auto compiled = derivativeCache.find(pattern)) return compiled;
+    }
+
+    auto compiled = std::make_shared<CompiledDerivatives>();
+    compiled->pattern = pattern;
+    compiled->dfa = Brzozowski::fromRegex(pattern, kDfaStateLimit, kDerivativeTermLimit, &compiled->terms);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return derivativeCache.insert(std::move(compiled));
+}
+
+void RegexCache::clear()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+    derivativeCache.clear();
+}
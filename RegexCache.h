@@ -0,0 +1,58 @@
+#ifndef REGEXCACHE_H
+#define REGEXCACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BitParallel.h"
+#include "Brzozowski.h"
+#include "Dfa.h"
+#include "Thompson.h"
+
+// Everything compiled from one pattern
+struct CompiledRegex {
+    std::string pattern;
+    NFA nfa;
+    std::vector<std::string> steps; // Thompson construction log
+    DFA dfa;     // subset construction; empty past RegexCache::kDfaStateLimit
+    DFA minimal; // Hopcroft-minimized dfa
+    PackedDFA packed; // minimal over byte classes, row-compressed for matching
+    std::shared_ptr<const BitParallelMatcher> bitParallel; // null past 127 positions
+
+    // false when the full DFA was too large
+    bool hasDfa() const { return dfa.stateCount > 0; }
+};
+
+// The DFA of one pattern built by Brzozowski derivatives
+struct CompiledDerivatives {
+    std::string pattern;
+    DFA dfa; // empty past RegexCache::kDfaStateLimit or kDerivativeTermLimit
+    std::vector<std::string> terms; // regex behind each state
+
+    bool hasDfa() const { return dfa.stateCount > 0; }
+};
+
+// ===============
+// RegexCache
+// ===============
+// Compiles patterns (Thompson NFA, subset construction, Hopcroft) and hands
+// out the shared result for matching and drawing, keeping the most recently
+// used ones. The derivative DFA is only built, and cached apart, when it is
+// asked for. Thread-safe.
+class RegexCache
+{
+public:
+    // Largest DFA built eagerly (1 KiB of table per state)
+    static constexpr int kDfaStateLimit = 4096;
+    // Regex terms interned before the derivative construction gives up
+    static constexpr int kDerivativeTermLimit = 1 << 17;
+    // Patterns kept per cache, least recently used dropped first
+    static constexpr int kCacheEntries = 16;
+
+    static std::shared_ptr<const CompiledRegex> get(const std::string& pattern);
+    static std::shared_ptr<const CompiledDerivatives> derivatives(const std::string& pattern);
+    static void clear();
+};
+
+#endif // REGEXCACHE_H
@@ -0,0 +1,218 @@
+#ifndef REGEXPARSER_H
+#define REGEXPARSER_H
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+// ===============
+// RegexParser
+// ===============
+// The regex syntax shared by the Thompson tab and the token spec:
+//
+//   a  0  =      bytes other than the ones below stand for themselves
+//   \c           any byte c, literally
+//   [a-z_] [^"]  byte class, with ranges and escapes; '^' negates; [] matches nothing
+//   r*  r+  r?   closure, one or more, optional
+//   rs  r.s      concatenation, implicit or explicit
+//   r|s          union (lowest precedence)
+//   (r)          capture group, numbered by its opening paren
+//
+// Whitespace is ignored, as are a stray ')' and a missing one at the end.
+// The parser drives a Builder that defines Term and the operations symbol,
+// anyOf, epsilon, unionOf, concat, closure, plus and group, so every
+// engine reads a pattern the same way.
+template <class Builder>
+class RegexParser
+{
+public:
+    using Term = typename Builder::Term;
+
+    // When steps is given, a description of each construction step is appended
+    explicit RegexParser(Builder& builder, std::vector<std::string>* steps = nullptr)
+        : builder(builder), steps(steps)
+    {
+    }
+
+    Term parse(const std::string& regex)
+    {
+        pattern = &regex;
+        i = 0;
+        depth = 0;
+        groupCount = 0;
+        return alternation();
+    }
+
+private:
+    Term alternation();
+    Term sequence();
+    bool factor(Term& out);
+    bool atom(Term& out);
+    std::string byteClass(); // after '[', up to and past ']'
+
+    static bool isMeta(char c)
+    {
+        return c == '\\' || c == '[' || c == ']' || c == '(' || c == ')' || c == '|'
+            || c == '*' || c == '+' || c == '?' || c == '.';
+    }
+    bool atEnd() const { return i >= pattern->size(); }
+    char peek() const { return (*pattern)[i]; }
+
+    void step(const std::string& s)
+    {
+        if (steps) steps->push_back(s);
+    }
+
+    Builder& builder;
+    std::vector<std::string>* steps;
+    const std::string* pattern = nullptr;
+    std::size_t i = 0;
+    int depth = 0; // open groups
+    int groupCount = 0;
+};
+
+template <class Builder>
+typename RegexParser<Builder>::Term RegexParser<Builder>::alternation()
+{
+    Term result = sequence();
+    while (!atEnd() && peek() == '|') {
+        ++i;
+        Term alternative = sequence();
+        step("Union");
+        result = builder.unionOf(result, alternative);
+    }
+    return result;
+}
+
+template <class Builder>
+typename RegexParser<Builder>::Term RegexParser<Builder>::sequence()
+{
+    std::vector<Term> factors;
+    while (!atEnd()) {
+        char c = peek();
+        if (c == '|') break;
+        if (c == ')') {
+            if (depth > 0) break;
+            ++i; // stray
+            continue;
+        }
+        if (c == '.') { // explicit concatenation
+            ++i;
+            continue;
+        }
+
+        const std::size_t before = i;
+        Term f{};
+        if (!factor(f)) {
+            if (i == before) ++i; // ignored character
+            continue;
+        }
+        factors.push_back(f);
+    }
+    if (factors.empty()) return builder.epsilon();
+
+    // Folded from the right, so each concat prepends one factor to a tail
+    // that is already built: O(1) for builders that keep concatenations
+    // right-nested, where a left fold would rebuild the tail every time
+    Term result = factors.back();
+    for (std::size_t k = factors.size() - 1; k-- > 0;) {
+        step("Concatenation");
+        result = builder.concat(factors[k], result);
+    }
+    return result;
+}
+
+template <class Builder>
+bool RegexParser<Builder>::factor(Term& out)
+{
+    if (!atom(out)) return false;
+    while (!atEnd()) {
+        char c = peek();
+        if (c == '*') {
+            step("Closure");
+            out = builder.closure(out);
+        } else if (c == '+') {
+            step("One or more");
+            out = builder.plus(out);
+        } else if (c == '?') {
+            step("Optional");
+            out = builder.unionOf(out, builder.epsilon());
+        } else {
+            break;
+        }
+        ++i;
+    }
+    return true;
+}
+
+template <class Builder>
+bool RegexParser<Builder>::atom(Term& out)
+{
+    char c = peek();
+    if (!std::isspace(static_cast<unsigned char>(c)) && !isMeta(c)) {
+        ++i;
+        step(std::string("Symbol: ") + c);
+        out = builder.symbol(static_cast<unsigned char>(c));
+        return true;
+    }
+    if (c == '\\') {
+        if (i + 1 >= pattern->size()) return false;
+        c = (*pattern)[i + 1];
+        i += 2;
+        step(std::string("Symbol: ") + c);
+        out = builder.symbol(static_cast<unsigned char>(c));
+        return true;
+    }
+    if (c == '[') {
+        const std::size_t open = i++;
+        std::string bytes = byteClass(); // empty: the class matches nothing
+        step("Class: " + pattern->substr(open, i - open));
+        out = builder.anyOf(bytes);
+        return true;
+    }
+    if (c == '(') {
+        ++i;
+        const int index = groupCount++;
+        ++depth;
+        Term inner = alternation();
+        --depth;
+        if (!atEnd()) ++i; // ')'
+        step("Group " + std::to_string(index + 1));
+        out = builder.group(inner, index);
+        return true;
+    }
+    return false;
+}
+
+template <class Builder>
+std::string RegexParser<Builder>::byteClass()
+{
+    bool member[256] = {};
+    bool negated = false;
+    if (!atEnd() && peek() == '^') {
+        negated = true;
+        ++i;
+    }
+    auto next = [&]() -> int { // one class byte, escapes resolved
+        char c = (*pattern)[i++];
+        if (c == '\\' && !atEnd()) c = (*pattern)[i++];
+        return static_cast<unsigned char>(c);
+    };
+    while (!atEnd() && peek() != ']') {
+        int from = next();
+        int to = from;
+        if (i + 1 < pattern->size() && peek() == '-' && (*pattern)[i + 1] != ']') {
+            ++i;
+            to = next();
+        }
+        for (int b = from; b <= to; ++b) member[b] = true;
+    }
+    if (!atEnd()) ++i; // ']'
+
+    std::string bytes;
+    for (int b = 0; b < 256; ++b)
+        if (member[b] != negated) bytes += static_cast<char>(b);
+    return bytes;
+}
+
+#endif // REGEXPARSER_H
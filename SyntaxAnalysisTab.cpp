@@ -1,4 +1,11 @@
 #include "SyntaxAnalysisTab.h"
+#include "Grammar.h"
+#include "LalrParser.h"
+#include "PdaParser.h"
+#include "PdaTraceModel.h"
+#include "TokenTableModel.h"
+#include <algorithm>
+#include <QComboBox>
 #include <QFont>
 #include <QHeaderView>
 #include <QHBoxLayout>
@@ -6,16 +13,9 @@
 #include <QTextEdit>
 #include <QPushButton>
 #include <QLabel>
-#include <QTableWidgetItem>
-#include <QSet>
-
-// ============================================================
-// FIX SUMMARY (IMPORTANT):
-// 1. Explicit EOF token "$" is appended automatically
-// 2. Program -> Statement Program now CONSUMES statements correctly
-// 3. Expression termination correctly handled (ExprRest / TermRest)
-// 4. Final ACCEPT condition simplified and correct
-// ============================================================
+#include <QListView>
+#include <QSpinBox>
+#include <QTableView>
 
 SyntaxAnalysisTab::SyntaxAnalysisTab(QWidget* parent)
     : QWidget(parent)
@@ -24,10 +24,11 @@ SyntaxAnalysisTab::SyntaxAnalysisTab(QWidget* parent)
     tokenlabel = new QLabel("Token Table", this);
     tokenlabel->setFont(QFont("Poppins", 14, QFont::Bold));
 
-    tokenizationtable = new QTableWidget(this);
-    tokenizationtable->setColumnCount(4);
-    tokenizationtable->setHorizontalHeaderLabels({"Token", "Type", "Line", "Column"});
+    tokenizationtable = new QTableView(this);
+    tokenizationtable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tokenizationtable->setSelectionBehavior(QAbstractItemView::SelectRows);
     tokenizationtable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    tokenizationtable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     tokenizationtable->verticalHeader()->setVisible(false);
 
     QVBoxLayout* leftLayout = new QVBoxLayout();
@@ -39,20 +40,41 @@ SyntaxAnalysisTab::SyntaxAnalysisTab(QWidget* parent)
     parserLabel->setFont(QFont("Poppins", 14, QFont::Bold));
     parserLabel->setAlignment(Qt::AlignCenter);
 
-    parserSimulator = new QTextEdit(this);
-    parserSimulator->setReadOnly(true);
+    traceModel = new PdaTraceModel(this);
+    parserSimulator = new QListView(this);
+    parserSimulator->setModel(traceModel);
     parserSimulator->setFont(QFont("Consolas", 11));
+    parserSimulator->setUniformItemSizes(true);
+    parserSimulator->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QLabel* stepLabel = new QLabel("Go to step", this);
+    stepBox = new QSpinBox(this);
+    stepBox->setRange(0, 0);
+    stepBox->setKeyboardTracking(false);
+
+    QHBoxLayout* stepLayout = new QHBoxLayout();
+    stepLayout->addWidget(stepLabel);
+    stepLayout->addWidget(stepBox, 1);
 
     parserValidator = new QTextEdit(this);
     parserValidator->setReadOnly(true);
 
+    backend = new QComboBox(this);
+    backend->addItem("LL(1) PDA (statement grammar)");
+    backend->addItem("LALR(1) shift-reduce (full grammar)");
+
     runParser = new QPushButton("Run Python PDA Parser", this);
 
+    QHBoxLayout* runLayout = new QHBoxLayout();
+    runLayout->addWidget(backend, 1);
+    runLayout->addWidget(runParser, 1);
+
     QVBoxLayout* rightLayout = new QVBoxLayout();
     rightLayout->addWidget(parserLabel);
     rightLayout->addWidget(parserSimulator);
+    rightLayout->addLayout(stepLayout);
     rightLayout->addWidget(parserValidator);
-    rightLayout->addWidget(runParser);
+    rightLayout->addLayout(runLayout);
 
     QHBoxLayout* mainLayout = new QHBoxLayout(this);
     QWidget* left = new QWidget(this);
@@ -64,115 +86,61 @@ SyntaxAnalysisTab::SyntaxAnalysisTab(QWidget* parent)
     mainLayout->addWidget(right, 3);
     setLayout(mainLayout);
 
+    // ================= TRACE NAVIGATION =================
+    connect(stepBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SyntaxAnalysisTab::showStep);
+    connect(parserSimulator, &QListView::clicked, this, [this](const QModelIndex& index) {
+        stepBox->setValue(index.row());
+        // Show the token the step was looking at
+        const int token = static_cast<int>(traceModel->trace().tokenAt(index.row()));
+        if (tokenModel && token < tokenModel->rowCount())
+            tokenizationtable->selectRow(token);
+    });
+
     // ================= PARSER =================
     connect(runParser, &QPushButton::clicked, this, [this]() {
-        parserSimulator->clear();
+        traceModel->clear();
         parserValidator->clear();
 
-        // ---------------- Tokens ----------------
-        QList<QString> tokens;
-        for (int i = 0; i < tokenizationtable->rowCount(); ++i) {
-            if (auto* item = tokenizationtable->item(i, 0)) {
-                if (!item->text().trimmed().isEmpty())
-                    tokens << item->text();
-            }
-        }
-        tokens << "$"; // ✅ FIX: explicit EOF
-
-        auto tokenType = [&](const QString& t) {
-            if (t == "$" || t == "+" || t == "-" || t == "*" || t == "/" || t == "//" || t == "%" || t == "**" || t == "="
-                || t == "(" || t == ")" || t == "[" || t == "]" || t == "{" || t == "}") return t;
-            if (t[0].isDigit()) return QString("number");
-            if (t[0].isLetter() || t[0] == '_') return QString("id");
-            if (t.startsWith('"') || t.startsWith('\'')) return QString("string");
-            return QString("INVALID");
-        };
-
-        // ---------------- Stack ----------------
-        QStringList stack;
-        stack << "$" << "Program";
-
-        int i = 0;
-        bool ok = true;
-
-        auto log = [&](QString s) { parserSimulator->append(s); };
-
-        log("START PDA\n");
-
-        while (!stack.isEmpty() && ok) {
-            QString top = stack.last();
-            QString cur = tokens[i];
-            QString type = tokenType(cur);
-
-            log(QString("STACK: %1 | INPUT: %2").arg(stack.join(" ")).arg(cur));
-
-            // ---------------- ACCEPT ----------------
-            if (top == "$" && cur == "$") break;
-
-            // ---------------- NON-TERMINALS ----------------
-            if (top == "Program") {
-                stack.removeLast();
-                if (cur != "$") {
-                    stack << "Program" << "Statement";
-                }
-            }
-            else if (top == "Statement") {
-                stack.removeLast();
-                if (type == "id" && tokens[i+1] == "=") stack << "Assignment";
-                else stack << "Expression";
-            }
-            else if (top == "Assignment") {
-                stack.removeLast();
-                stack << "Expression" << "=" << "id";
-            }
-            else if (top == "Expression") {
-                stack.removeLast();
-                stack << "ExprRest" << "Term";
-            }
-            else if (top == "ExprRest") {
-                stack.removeLast();
-                if (cur == "+" || cur == "-") stack << "ExprRest" << "Term" << cur;
-            }
-            else if (top == "Term") {
-                stack.removeLast();
-                stack << "TermRest" << "Factor";
-            }
-            else if (top == "TermRest") {
-                stack.removeLast();
-                if (cur == "*" || cur == "/" || cur == "//" || cur == "%" || cur == "**")
-                    stack << "TermRest" << "Factor" << cur;
-            }
-            else if (top == "Factor") {
-                stack.removeLast();
-                if (cur == "(") stack << ")" << "Expression" << "(";
-                else if (type == "id") stack << "id";
-                else if (type == "number") stack << "number";
-                else if (type == "string") stack << "string";
-                else ok = false;
-            }
-            // ---------------- TERMINALS ----------------
-            else {
-                if (top == type || top == cur) {
-                    stack.removeLast();
-                    i++;
-                } else {
-                    ok = false;
-                }
-            }
-        }
-
-        if (ok && stack == QStringList({"$"}) && tokens[i] == "$") {
-            parserValidator->setText("✅ ACCEPTED");
+        const TokenStream stream = tokenModel ? tokenModel->tokens() : TokenStream();
+        PdaTrace trace;
+        PdaParser::Result result;
+        QString details;
+        if (backend->currentIndex() == 1) {
+            const LalrTable& table = LalrParser::table();
+            details = QString("LALR(1) table: %1 states, %2 conflicts")
+                          .arg(table.stateCount())
+                          .arg(static_cast<int>(table.conflicts().size()));
+            for (const std::string& conflict : table.conflicts())
+                details += "\n  " + QString::fromStdString(conflict);
+            result = LalrParser::parse(stream, &trace);
         } else {
-            parserValidator->setText("❌ REJECTED");
+            result = PdaParser::parse(stream, &trace);
         }
+
+        if (!details.isEmpty()) details += '\n';
+        details += QString("%1 steps, trace %2 KiB")
+                       .arg(static_cast<qulonglong>(trace.stepCount()))
+                       .arg(static_cast<qulonglong>(trace.bytes() / 1024));
+        const int lastStep = std::max(static_cast<int>(trace.stepCount()) - 1, 0);
+        traceModel->setTrace(std::move(trace));
+        stepBox->setRange(0, lastStep);
+        stepBox->setValue(lastStep);
+        showStep(lastStep); // the step that accepted or failed
+
+        parserValidator->setText((result.accepted ? "✅ ACCEPTED\n" : "❌ REJECTED\n") + details);
     });
 }
 
-void SyntaxAnalysisTab::updateTokenTable(const QList<QList<QString>>& tokens)
+void SyntaxAnalysisTab::showStep(int step)
+{
+    if (step >= traceModel->rowCount()) return;
+    const QModelIndex index = traceModel->index(step);
+    parserSimulator->setCurrentIndex(index);
+    parserSimulator->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void SyntaxAnalysisTab::setTokenModel(TokenTableModel* model)
 {
-    tokenizationtable->setRowCount(tokens.size());
-    for (int i = 0; i < tokens.size(); ++i)
-        for (int j = 0; j < tokens[i].size() && j < 4; ++j)
-            tokenizationtable->setItem(i, j, new QTableWidgetItem(tokens[i][j]));
+    tokenModel = model;
+    tokenizationtable->setModel(model);
 }
@@ -5,9 +5,14 @@
 #include <QList>
 
 class QLabel;
-class QTableWidget;
+class QListView;
+class QSpinBox;
+class QTableView;
+class PdaTraceModel;
+class TokenTableModel;
 class QTextEdit;
 class QPushButton;
+class QComboBox;
 
 class SyntaxAnalysisTab : public QWidget
 {
@@ -15,16 +20,24 @@ class SyntaxAnalysisTab : public QWidget
 
 public:
     SyntaxAnalysisTab(QWidget* parent = nullptr);
-    void updateTokenTable(const QList<QList<QString>>& tokens);
+    // Shows (and parses) the token table owned by the Lexical Analysis tab
+    void setTokenModel(TokenTableModel* model);
 
 private:
+    void showStep(int step); // selects and centers a trace row
+
     // Token Table (Left Side)
     QLabel* tokenlabel;
-    QTableWidget* tokenizationtable;
+    QTableView* tokenizationtable;
+    TokenTableModel* tokenModel = nullptr;
 
-    // Unified PDA Parser (Right Side)
-    QTextEdit* parserSimulator;
+    // Unified PDA Parser (Right Side): the recorded trace, shown one step
+    // per row and only formatted for the rows on screen
+    QListView* parserSimulator;
+    PdaTraceModel* traceModel;
+    QSpinBox* stepBox; // jumps to a step
     QTextEdit* parserValidator;
+    QComboBox* backend; // LL(1) PDA or LALR(1)
     QPushButton* runParser;
 };
 
@@ -0,0 +1,155 @@
+#include "Thompson.h"
+
+#include "RegexParser.h"
+
+// ==========================
+//   Thompson IMPLEMENTATION
+// ==========================
+
+namespace {
+
+constexpr std::int32_t kEndOfChain = -1;
+
+} // namespace
+
+void Thompson::patch(int head, int to)
+{
+    for (int e = head; e != kEndOfChain;) {
+        int next = arena.target(e);
+        arena.setTarget(e, to);
+        e = next;
+    }
+}
+
+// Fragment starting at start whose dangling edges are f1's then f2's.
+// A fragment that matches nothing has no dangling edges at all.
+Fragment Thompson::join(Fragment f1, Fragment f2, int start)
+{
+    if (f1.outHead == kEndOfChain) return {start, f2.outHead, f2.outTail};
+    if (f2.outHead == kEndOfChain) return {start, f1.outHead, f1.outTail};
+    arena.setTarget(f1.outTail, f2.outHead);
+    return {start, f1.outHead, f2.outTail};
+}
+
+Fragment Thompson::symbol(unsigned char symbol)
+{
+    int s = arena.addState();
+    int e = arena.addEdge(s, kEndOfChain, symbol);
+    return {s, e, e};
+}
+
+Fragment Thompson::anyOf(std::string_view bytes)
+{
+    int s = arena.addState();
+    int head = kEndOfChain, tail = kEndOfChain;
+    for (char c : bytes) {
+        int e = arena.addEdge(s, kEndOfChain, static_cast<unsigned char>(c));
+        if (tail == kEndOfChain) head = e;
+        else arena.setTarget(tail, e);
+        tail = e;
+    }
+    return {s, head, tail};
+}
+
+Fragment Thompson::epsilon()
+{
+    int s = arena.addState();
+    int e = arena.addEpsilon(s, kEndOfChain);
+    return {s, e, e};
+}
+
+// Union operation: f1 | f2
+Fragment Thompson::unionOf(Fragment f1, Fragment f2)
+{
+    int fork = arena.addState();
+    arena.addEpsilon(fork, f1.start);
+    arena.addEpsilon(fork, f2.start);
+    return join(f1, f2, fork);
+}
+
+// Concatenation operation: f1 f2
+Fragment Thompson::concat(Fragment f1, Fragment f2)
+{
+    patch(f1.outHead, f2.start);
+    return {f1.start, f2.outHead, f2.outTail};
+}
+
+// Closure operation: f* (Kleene Star)
+Fragment Thompson::closure(Fragment f)
+{
+    int loop = arena.addState();
+    arena.addEpsilon(loop, f.start);
+    int exit = arena.addEpsilon(loop, kEndOfChain);
+    patch(f.outHead, loop);
+    return {loop, exit, exit};
+}
+
+// One or more: f+, looping back to f after each pass
+Fragment Thompson::plus(Fragment f)
+{
+    int loop = arena.addState();
+    patch(f.outHead, loop);
+    arena.addEpsilon(loop, f.start);
+    int exit = arena.addEpsilon(loop, kEndOfChain);
+    return {f.start, exit, exit};
+}
+
+// Capture group: (f), recording the positions where f starts and ends
+Fragment Thompson::group(Fragment f, int index)
+{
+    int open = arena.addState();
+    arena.addSave(open, f.start, 2 * index);
+    int close = arena.addState();
+    patch(f.outHead, close);
+    int exit = arena.addSave(close, kEndOfChain, 2 * index + 1);
+    return {open, exit, exit};
+}
+
+NFA Thompson::finish(Fragment f)
+{
+    int accept = arena.addState(true);
+    patch(f.outHead, accept);
+    NFA raw = arena.build(f.start, accept);
+    arena = NFABuilder();
+
+    // Renumber breadth-first so diagrams read from the start state outward
+    const int n = raw.stateCount();
+    std::vector<int> order(n, -1);
+    std::vector<int> queue;
+    queue.reserve(n);
+    order[raw.startState] = 0;
+    queue.push_back(raw.startState);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        for (const auto& e : raw.out(queue[i])) {
+            if (order[e.to] != -1) continue;
+            order[e.to] = static_cast<int>(queue.size());
+            queue.push_back(e.to);
+        }
+    }
+
+    NFABuilder b;
+    b.reserve(queue.size(), raw.edges.size());
+    for (int s : queue) b.addState(raw.isAccept(s));
+    for (int s : queue) {
+        for (auto e : raw.out(s)) {
+            e.to = order[e.to];
+            b.add(order[s], e);
+        }
+    }
+    return b.build(0, order[accept]); // -1 when nothing can be accepted
+}
+
+NFA Thompson::fromRegex(const std::string& regex, std::vector<std::string>* steps)
+{
+    if (regex.empty()) {
+        NFABuilder b;
+        int s0 = b.addState(true);
+        if (steps) steps->push_back("Empty regex");
+        return b.build(s0, s0);
+    }
+
+    // Typically at most two states and two edges per character
+    Thompson t;
+    t.arena.reserve(2 * regex.size() + 1, 2 * regex.size());
+    return t.finish(RegexParser<Thompson>(t, steps).parse(regex));
+}
@@ -0,0 +1,59 @@
+#ifndef THOMPSON_H
+#define THOMPSON_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Nfa.h"
+
+// ===============
+// Fragment
+// ===============
+// A partially built automaton inside a Thompson arena: its start state and
+// the chain of out-edges that still have no target. The chain is threaded
+// through the unset targets themselves, so joining two chains is O(1).
+struct Fragment {
+    int start;
+    int outHead; // first dangling edge
+    int outTail; // last dangling edge (its target ends the chain: -1)
+};
+
+// ===============
+// Thompson
+// ===============
+// Thompson's construction in the style of Pike's implementation: all
+// fragments are appended to one growing arena and an operator only adds
+// its own states and patches its operands' dangling edges, so building an
+// NFA is O(regex length). Each fragment may be used as an operand once.
+class Thompson
+{
+public:
+    using Term = Fragment; // for RegexParser
+
+    Fragment symbol(unsigned char symbol);
+    Fragment anyOf(std::string_view bytes); // character class; no bytes matches nothing
+    Fragment epsilon();
+    Fragment unionOf(Fragment f1, Fragment f2);
+    Fragment concat(Fragment f1, Fragment f2);
+    Fragment closure(Fragment f);
+    Fragment plus(Fragment f); // f f*, without copying f
+    Fragment group(Fragment f, int index); // capture group; slots 2i, 2i + 1
+
+    // Points f's dangling edges at a new accept state and returns the NFA,
+    // with states numbered in breadth-first order from the start state.
+    // The arena is left empty for the next construction.
+    NFA finish(Fragment f);
+
+    // Builds an NFA for a regex in RegexParser's syntax. When steps is
+    // given, a description of each construction step is appended.
+    static NFA fromRegex(const std::string& regex, std::vector<std::string>* steps = nullptr);
+
+private:
+    void patch(int head, int to);
+    Fragment join(Fragment f1, Fragment f2, int start);
+
+    NFABuilder arena;
+};
+
+#endif // THOMPSON_H
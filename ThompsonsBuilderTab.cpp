@@ -9,8 +9,9 @@
 #include <QBrush>
 #include <QLabel>
 #include <QFont>
-#include <QStack>
 #include <QMap>
+#include <QLineF>
+#include <QtMath>
 #include <QDebug>
 
 ThompsonsBuilderTab::ThompsonsBuilderTab(QWidget *parent)
@@ -29,7 +30,7 @@ ThompsonsBuilderTab::ThompsonsBuilderTab(QWidget *parent)
 
     regexInput = new QLineEdit(this);
     regexInput->setFont(QFont("Consolas", 12));
-    regexInput->setPlaceholderText("Try: a, a*, ab, a|b, a*b|c");
+    regexInput->setPlaceholderText("Try: a, a*, ab, a|b, a*b|c, (a|b)*c");
     regexInput->setText("a|b");
     connect(regexInput, &QLineEdit::textChanged, this, [this]() {
         buildNFA();
@@ -40,10 +41,46 @@ ThompsonsBuilderTab::ThompsonsBuilderTab(QWidget *parent)
     buildButton = new QPushButton("Build NFA", this);
     buildButton->setFont(QFont("Poppins", 10, QFont::Bold));
     buildButton->setStyleSheet("background-color: #16163F; color: white; padding: 11px 28px;");
+    engine = new QComboBox(this);
+    engine->setFont(QFont("Poppins", 10));
+    engine->addItem("Thompson + Subset Construction");
+    engine->addItem("Brzozowski Derivatives");
+    connect(engine, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        buildNFA();
+    });
+    viewMode = new QComboBox(this);
+    viewMode->setFont(QFont("Poppins", 10));
+    viewMode->addItem("NFA (Thompson)");
+    viewMode->addItem("DFA");
+    viewMode->addItem("Minimized DFA (Hopcroft)");
+    connect(viewMode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        buildNFA();
+    });
+    btnLayout->addWidget(engine);
+    btnLayout->addWidget(viewMode);
     btnLayout->addStretch();
     btnLayout->addWidget(buildButton);
     layout->addLayout(btnLayout);
 
+    QHBoxLayout* testLayout = new QHBoxLayout();
+    QLabel* testLabel = new QLabel("Test string:", this);
+    testLabel->setFont(QFont("Poppins", 10));
+    testInput = new QLineEdit(this);
+    testInput->setFont(QFont("Consolas", 12));
+    testInput->setPlaceholderText("Input to match against the minimized DFA");
+    matchLabel = new QLabel(this);
+    matchLabel->setFont(QFont("Poppins", 10, QFont::Bold));
+    connect(testInput, &QLineEdit::textChanged, this, &ThompsonsBuilderTab::updateMatch);
+    testLayout->addWidget(testLabel);
+    testLayout->addWidget(testInput, 1);
+    testLayout->addWidget(matchLabel);
+    layout->addLayout(testLayout);
+
+    searchLabel = new QLabel(this);
+    searchLabel->setFont(QFont("Consolas", 10));
+    searchLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(searchLabel);
+
     buildLog = new QTextEdit(this);
     buildLog->setFont(QFont("Consolas", 10));
     buildLog->setReadOnly(true);
@@ -68,150 +105,6 @@ ThompsonsBuilderTab::ThompsonsBuilderTab(QWidget *parent)
     connect(buildButton, &QPushButton::clicked, this, &ThompsonsBuilderTab::buildNFA);
 }
 
-// --- NFA Construction (unchanged) ---
-ThompsonsBuilderTab::NFA ThompsonsBuilderTab::createSymbolNFA(const QString& symbol)
-{
-    NFA nfa;
-    nfa.states = { {0, false}, {1, true} };
-    nfa.transitions = { {0, symbol, 1} };
-    nfa.startState = 0;
-    nfa.acceptState = 1;
-    return nfa;
-}
-
-ThompsonsBuilderTab::NFA ThompsonsBuilderTab::unionNFA(const NFA& n1, const NFA& n2)
-{
-    NFA result;
-    int nextId = 0;
-    result.states.append({nextId++, false}); // new start
-    result.states.append({nextId++, true});  // new accept
-    int newStart = result.states[0].id;
-    int newAccept = result.states[1].id;
-
-    QMap<int, int> idMap;
-    auto addStates = [&](const QList<NFAState>& states) {
-        for (const auto& s : states) {
-            idMap[s.id] = nextId++;
-            result.states.append({idMap[s.id], s.isAccept});
-        }
-    };
-    addStates(n1.states);
-    addStates(n2.states);
-
-    result.transitions.append({newStart, "ε", idMap[n1.startState]});
-    result.transitions.append({newStart, "ε", idMap[n2.startState]});
-    for (const auto& s : n1.states) if (s.isAccept) result.transitions.append({idMap[s.id], "ε", newAccept});
-    for (const auto& s : n2.states) if (s.isAccept) result.transitions.append({idMap[s.id], "ε", newAccept});
-    for (const auto& t : n1.transitions) result.transitions.append({idMap[t.from], t.symbol, idMap[t.to]});
-    for (const auto& t : n2.transitions) result.transitions.append({idMap[t.from], t.symbol, idMap[t.to]});
-
-    result.startState = newStart;
-    result.acceptState = newAccept;
-    return result;
-}
-
-ThompsonsBuilderTab::NFA ThompsonsBuilderTab::concatNFA(const NFA& n1, const NFA& n2)
-{
-    NFA result = n1;
-    int offset = n1.states.size();
-    for (const auto& s : n2.states) result.states.append({s.id + offset, s.isAccept});
-    for (auto& s : result.states) if (s.id == n1.acceptState) s.isAccept = false;
-    result.transitions.append({n1.acceptState, "ε", n2.startState + offset});
-    for (const auto& t : n2.transitions) result.transitions.append({t.from + offset, t.symbol, t.to + offset});
-    result.acceptState = n2.acceptState + offset;
-    return result;
-}
-
-ThompsonsBuilderTab::NFA ThompsonsBuilderTab::closureNFA(const NFA& n)
-{
-    NFA result;
-    int nextId = 0;
-    result.states.append({nextId++, false});
-    result.states.append({nextId++, true});
-    int newStart = result.states[0].id;
-    int newAccept = result.states[1].id;
-
-    QMap<int, int> idMap;
-    for (const auto& s : n.states) { idMap[s.id] = nextId++; result.states.append({idMap[s.id], s.isAccept}); }
-
-    result.transitions.append({newStart, "ε", idMap[n.startState]});
-    result.transitions.append({newStart, "ε", newAccept});
-    for (const auto& s : n.states) {
-        if (s.isAccept) {
-            result.transitions.append({idMap[s.id], "ε", idMap[n.startState]});
-            result.transitions.append({idMap[s.id], "ε", newAccept});
-            for (auto& rs : result.states) if (rs.id == idMap[s.id]) rs.isAccept = false;
-        }
-    }
-    for (const auto& t : n.transitions) result.transitions.append({idMap[t.from], t.symbol, idMap[t.to]});
-
-    result.startState = newStart;
-    result.acceptState = newAccept;
-    return result;
-}
-
-// --- NFA Building (unchanged) ---
-ThompsonsBuilderTab::NFA ThompsonsBuilderTab::buildFromRegex(const QString& regex)
-{
-    buildSteps.clear();
-    if (regex.isEmpty()) {
-        NFA nfa;
-        nfa.states = {{0, true}};
-        nfa.startState = 0;
-        nfa.acceptState = 0;
-        buildSteps.append({"Empty regex"});
-        return nfa;
-    }
-
-    QStack<NFA> operandStack;
-    QStack<QChar> operatorStack;
-
-    auto applyOperator = [&]() {
-        if (operatorStack.isEmpty()) return;
-        QChar op = operatorStack.pop();
-        if (op == '|') {
-            if (operandStack.size() >= 2) {
-                NFA n2 = operandStack.pop();
-                NFA n1 = operandStack.pop();
-                buildSteps.append({"Union: " + operandStack.empty() ? "" : ""}); // simplified
-                operandStack.push(unionNFA(n1, n2));
-            }
-        }
-    };
-
-    for (int i = 0; i < regex.length(); ++i) {
-        QChar c = regex[i];
-        if (c.isLetterOrNumber() || c == '_') {
-            operandStack.push(createSymbolNFA(QString(c)));
-            if (i + 1 < regex.length()) {
-                QChar next = regex[i + 1];
-                if (next.isLetterOrNumber() || next == '_' || next == '(' || next == '*') {
-                    operatorStack.push('.');
-                }
-            }
-        } else if (c == '*') {
-            if (!operandStack.isEmpty()) {
-                NFA n = operandStack.pop();
-                operandStack.push(closureNFA(n));
-            }
-        } else if (c == '|') {
-            applyOperator();
-            operatorStack.push('|');
-        } else if (c == '.') {
-            operatorStack.push('.');
-        }
-    }
-    applyOperator();
-
-    while (operandStack.size() > 1) {
-        NFA n2 = operandStack.pop();
-        NFA n1 = operandStack.pop();
-        operandStack.push(concatNFA(n1, n2));
-    }
-
-    return operandStack.isEmpty() ? createSymbolNFA("ε") : operandStack.top();
-}
-
 // --- DRAWING WITH STRUCTURED LAYOUT ---
 void ThompsonsBuilderTab::drawNFA(const NFA& nfa)
 {
@@ -223,18 +116,20 @@ void ThompsonsBuilderTab::drawNFA(const NFA& nfa)
     int forkState = -1, joinState = -1;
     QMap<int, QList<int>> outTrans, inTrans;
 
-    for (const auto& t : nfa.transitions) {
-        outTrans[t.from].append(t.to);
-        inTrans[t.to].append(t.from);
-        if (t.symbol == "ε") {
-            // Detect fork: state with 2+ outgoing ε
-            if (outTrans[t.from].size() >= 2) {
-                isUnion = true;
-                forkState = t.from;
-            }
-            // Detect join: state with 2+ incoming ε
-            if (inTrans[t.to].size() >= 2) {
-                joinState = t.to;
+    for (int from = 0; from < nfa.stateCount(); ++from) {
+        for (const auto& e : nfa.out(from)) {
+            outTrans[from].append(e.to);
+            inTrans[e.to].append(from);
+            if (e.epsilon) {
+                // Detect fork: state with 2+ outgoing ε
+                if (outTrans[from].size() >= 2) {
+                    isUnion = true;
+                    forkState = from;
+                }
+                // Detect join: state with 2+ incoming ε
+                if (inTrans[e.to].size() >= 2) {
+                    joinState = e.to;
+                }
             }
         }
     }
@@ -260,39 +155,54 @@ void ThompsonsBuilderTab::drawNFA(const NFA& nfa)
         if (leftBranch != -1) statePositions[leftBranch] = QPointF(startX + 240, startY - 60);
         if (rightBranch != -1) statePositions[rightBranch] = QPointF(startX + 240, startY + 60);
         if (joinState != -1) statePositions[joinState] = QPointF(startX + 360, startY);
-        statePositions[nfa.acceptState] = QPointF(startX + 480, startY);
+        if (nfa.acceptState >= 0) statePositions[nfa.acceptState] = QPointF(startX + 480, startY);
     } else {
         // Default linear layout
         int step = 140;
-        for (int i = 0; i < nfa.states.size(); ++i) {
-            statePositions[nfa.states[i].id] = QPointF(startX + i * step, startY);
+        for (int i = 0; i < nfa.stateCount(); ++i) {
+            statePositions[i] = QPointF(startX + i * step, startY);
         }
     }
 
     // Draw states
     QMap<int, QGraphicsEllipseItem*> stateItems;
-    for (const auto& state : nfa.states) {
-        if (!statePositions.contains(state.id)) continue;
-        QPointF pos = statePositions[state.id];
-        QBrush brush = state.id == nfa.startState ? QColor("#E9ECEF") :
-                      state.isAccept ? QColor("#28A745") : Qt::white;
-
-        if (state.isAccept) {
+    for (int id = 0; id < nfa.stateCount(); ++id) {
+        if (!statePositions.contains(id)) continue;
+        QPointF pos = statePositions[id];
+        const bool isAccept = nfa.isAccept(id);
+        QBrush brush = id == nfa.startState ? QColor("#E9ECEF") :
+                      isAccept ? QColor("#28A745") : Qt::white;
+
+        if (isAccept) {
             scene->addEllipse(pos.x()-35, pos.y()-35, 70, 70, QPen(QColor("#28A745"), 1), Qt::NoBrush);
         }
         auto circle = scene->addEllipse(pos.x()-30, pos.y()-30, 60, 60, QPen(Qt::black, 2), brush);
-        auto text = scene->addText(QString::number(state.id));
+        auto text = scene->addText(QString::number(id));
         text->setFont(QFont("Arial", 12, QFont::Bold));
         text->setPos(pos.x() - text->boundingRect().width()/2,
                      pos.y() - text->boundingRect().height()/2);
-        stateItems[state.id] = circle;
+        stateItems[id] = circle;
     }
 
-    // Draw transitions
-    for (const auto& trans : nfa.transitions) {
-        if (!stateItems.contains(trans.from) || !stateItems.contains(trans.to)) continue;
-        QPointF from = statePositions[trans.from];
-        QPointF to = statePositions[trans.to];
+    // Draw transitions; parallel edges (a DFA has one per byte) share an arrow
+    for (const auto& edge : mergedEdges(nfa)) {
+        const int fromId = edge.from;
+        const int toId = edge.to;
+        const QString symbol = QString::fromStdString(edge.label);
+        if (!stateItems.contains(fromId) || !stateItems.contains(toId)) continue;
+        QPointF from = statePositions[fromId];
+        QPointF to = statePositions[toId];
+
+        // DFA self-loops: small circle above the state
+        if (fromId == toId) {
+            scene->addEllipse(from.x() - 15, from.y() - 60, 30, 34, QPen(Qt::black, 2), Qt::NoBrush);
+            auto label = scene->addText(symbol);
+            label->setFont(QFont("Arial", 11));
+            label->setDefaultTextColor(Qt::darkBlue);
+            label->setPos(from.x() - label->boundingRect().width()/2,
+                          from.y() - 60 - label->boundingRect().height());
+            continue;
+        }
 
         // Straight line
         scene->addLine(from.x(), from.y(), to.x(), to.y(), QPen(Qt::black, 2));
@@ -307,7 +217,7 @@ void ThompsonsBuilderTab::drawNFA(const NFA& nfa)
 
         // Label near 'from'
         QPointF labelPos = from * 0.75 + to * 0.25;
-        auto label = scene->addText(trans.symbol);
+        auto label = scene->addText(symbol);
         label->setFont(QFont("Arial", 11));
         label->setDefaultTextColor(Qt::darkBlue);
         label->setPos(labelPos.x() - label->boundingRect().width()/2,
@@ -326,19 +236,119 @@ void ThompsonsBuilderTab::buildNFA()
 {
     QString regex = regexInput->text().trimmed();
     if (regex.isEmpty()) {
+        compiled.reset();
+        lazyMatcher.reset();
         graphicsView->scene()->clear();
         buildLog->setPlainText("Enter a regex to build NFA.");
         stepLog->clear();
+        updateMatch();
         return;
     }
 
-    buildLog->setPlainText("Building NFA for: " + regex);
-    NFA nfa = buildFromRegex(regex);
+    // Each pattern is compiled and determinized once
+    auto previous = compiled;
+    compiled = RegexCache::get(regex.toStdString());
+    if (compiled != previous) {
+        const bool needsLazy = !compiled->bitParallel && !compiled->hasDfa();
+        lazyMatcher = needsLazy ? std::make_unique<LazyDFA>(compiled->nfa) : nullptr;
+    }
+    // The derivative DFA is only built while its engine is picked
+    std::shared_ptr<const CompiledDerivatives> derived;
+    if (engine->currentIndex() == 1) derived = RegexCache::derivatives(regex.toStdString());
+    const bool showDfa = viewMode->currentIndex() != 0;
+    const bool derivatives = derived && viewMode->currentIndex() == 1;
+    const DFA& dfa = viewMode->currentIndex() == 2 ? compiled->minimal
+                   : derivatives ? derived->dfa
+                   : compiled->dfa;
+
+    if (compiled->hasDfa()) {
+        buildLog->setPlainText(QString("Built NFA for: %1 (%2 NFA states, %3 DFA states, %4 minimized)")
+                                   .arg(regex)
+                                   .arg(compiled->nfa.stateCount())
+                                   .arg(compiled->dfa.stateCount)
+                                   .arg(compiled->minimal.stateCount));
+    } else {
+        buildLog->setPlainText(QString("Built NFA for: %1 (%2 NFA states); the DFA exceeds %3 states")
+                                   .arg(regex)
+                                   .arg(compiled->nfa.stateCount())
+                                   .arg(RegexCache::kDfaStateLimit));
+    }
+    if (compiled->bitParallel) {
+        buildLog->append(QString("Matching: bit-parallel Glushkov, %1 positions%2")
+                             .arg(compiled->bitParallel->positionCount())
+                             .arg(compiled->bitParallel->isShiftAnd() ? " (Shift-And)" : ""));
+    } else {
+        buildLog->append(compiled->hasDfa()
+                             ? QString("Matching: minimized DFA, %1 byte classes, %2 bytes packed")
+                                   .arg(compiled->packed.classCount())
+                                   .arg(compiled->packed.tableBytes())
+                             : QString("Matching: lazy DFA"));
+    }
+    if (derived) {
+        buildLog->append(derived->hasDfa()
+                             ? QString("Derivatives: %1 DFA states").arg(derived->dfa.stateCount)
+                             : QString("Derivatives: gave up past %1 DFA states or %2 regex terms")
+                                   .arg(RegexCache::kDfaStateLimit)
+                                   .arg(RegexCache::kDerivativeTermLimit));
+    }
 
     // Update steps
     QStringList steps;
-    for (const auto& s : buildSteps) steps << "• " + s.description;
+    for (const auto& s : compiled->steps) steps << "• " + QString::fromStdString(s);
+    if (derivatives) {
+        for (int d = 0; d < dfa.stateCount; ++d) {
+            steps << QString("• DFA state %1 = %2%3")
+                         .arg(d)
+                         .arg(QString::fromStdString(derived->terms[d]))
+                         .arg(dfa.isAccepting(d) ? " (accept)" : "");
+        }
+    } else if (showDfa) {
+        for (int d = 0; d < dfa.stateCount; ++d) {
+            QStringList members;
+            for (int s : dfa.nfaStates[d]) members << QString::number(s);
+            steps << QString("• DFA state %1 = {%2}%3")
+                         .arg(d)
+                         .arg(members.join(", "))
+                         .arg(dfa.isAccepting(d) ? " (accept)" : "");
+        }
+    }
     stepLog->setPlainText(steps.join("\n"));
 
-    drawNFA(nfa);
+    if (showDfa && dfa.stateCount == 0) graphicsView->scene()->clear();
+    else drawNFA(showDfa ? dfa.toGraph() : compiled->nfa);
+    updateMatch();
+}
+
+void ThompsonsBuilderTab::updateMatch()
+{
+    if (!compiled || testInput->text().isEmpty()) {
+        matchLabel->clear();
+        searchLabel->clear();
+        return;
+    }
+
+    const std::string input = testInput->text().toStdString();
+    bool matched = compiled->bitParallel ? compiled->bitParallel->matches(input)
+                 : lazyMatcher ? lazyMatcher->matches(input)
+                 : compiled->packed.matches(input);
+    matchLabel->setText(matched ? "✅ MATCH" : "❌ NO MATCH");
+    matchLabel->setStyleSheet(matched ? "color: #28A745;" : "color: #DC3545;");
+
+    // Leftmost-longest occurrence and its capture groups (Pike VM, byte offsets)
+    RegexMatch found = PikeVM::search(compiled->nfa, input);
+    if (!found.found) {
+        searchLabel->setText("Search: no occurrence");
+        return;
+    }
+    QString text = QString("Search: [%1, %2) \"%3\"")
+                       .arg(found.start)
+                       .arg(found.end)
+                       .arg(QString::fromStdString(input.substr(found.start, found.end - found.start)));
+    for (std::size_t g = 0; g < found.groups.size(); ++g) {
+        const auto& span = found.groups[g];
+        text += QString("   group %1: ").arg(g + 1);
+        if (span.first < 0) text += "unset";
+        else text += QString("[%1, %2)").arg(span.first).arg(span.second);
+    }
+    searchLabel->setText(text);
 }
\ No newline at end of file
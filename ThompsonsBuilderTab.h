@@ -6,6 +6,14 @@
 #include <QTextEdit>
 #include <QGraphicsView>
 #include <QPushButton>
+#include <QComboBox>
+#include <QLabel>
+
+#include <memory>
+
+#include "PikeVm.h"
+#include "RegexCache.h"
+#include "Thompson.h"
 
 class ThompsonsBuilderTab : public QWidget
 {
@@ -16,43 +24,22 @@ public:
 
 private slots:
     void buildNFA();
+    void updateMatch();
 
 private:
-    struct NFAState {
-        int id;
-        bool isAccept = false;
-    };
-
-    struct NFATransition {
-        int from;
-        QString symbol; // "ε" or character
-        int to;
-    };
-
-    struct BuildStep {
-        QString description;
-    };
-
     QLineEdit* regexInput;
     QTextEdit* buildLog;
     QTextEdit* stepLog;
     QGraphicsView* graphicsView;
     QPushButton* buildButton;
+    QComboBox* engine;       // subset construction or derivatives for the DFA view
+    QComboBox* viewMode;     // NFA, DFA or minimized DFA
+    QLineEdit* testInput;
+    QLabel* matchLabel;
+    QLabel* searchLabel;     // leftmost-longest match and capture spans
+    std::shared_ptr<const CompiledRegex> compiled;
+    std::unique_ptr<LazyDFA> lazyMatcher; // when neither bit-parallel nor a full DFA fits
 
-    using NFA = struct {
-        int startState;
-        int acceptState;
-        QList<NFAState> states;
-        QList<NFATransition> transitions;
-    };
-
-    QList<BuildStep> buildSteps; // Tracks construction steps
-
-    NFA createSymbolNFA(const QString& symbol);
-    NFA unionNFA(const NFA& n1, const NFA& n2);
-    NFA concatNFA(const NFA& n1, const NFA& n2);
-    NFA closureNFA(const NFA& n);
-    NFA buildFromRegex(const QString& regex);
     void drawNFA(const NFA& nfa);
 };
 
@@ -0,0 +1,158 @@
+#include "ThreadPool.h"
+
+namespace {
+
+// Identifies the pool worker running on this thread, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local unsigned currentWorker = 0;
+
+} // namespace
+
+// ==========================
+//   ThreadPool IMPLEMENTATION
+// ==========================
+
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned i = 0; i < threadCount; ++i)
+        queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void ThreadPool::submit(Task task)
+{
+    unsigned index = currentPool == this
+        ? currentWorker
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        // Count the task before it becomes visible so pending never underflows
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pending.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::popTask(unsigned self, Task& task)
+{
+    const unsigned n = static_cast<unsigned>(queues.size());
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (unsigned k = 1; k < n; ++k) {
+        Queue& victim = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask()
+{
+    if (pending.load(std::memory_order_acquire) == 0) return false;
+
+    unsigned self = currentPool == this
+        ? currentWorker
+        : nextQueue.load(std::memory_order_relaxed) % queues.size();
+    Task task;
+    if (!popTask(self, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    for (;;) {
+        Task task;
+        if (popTask(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+        if (stopping && pending.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+// ==========================
+//   TaskGroup IMPLEMENTATION
+// ==========================
+
+void TaskGroup::run(ThreadPool::Task task)
+{
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+    pool.submit([this, task = std::move(task)]() {
+        // Counted down however the task ends, or wait() would never return
+        struct Finish {
+            TaskGroup* group;
+            ~Finish() { group->finish(); }
+        } finish{this};
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+    });
+}
+
+void TaskGroup::finish()
+{
+    // Under the mutex, so the waiter cannot return and destroy the group
+    // between the decrement and the notify
+    std::lock_guard<std::mutex> lock(mutex);
+    if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) done.notify_all();
+}
+
+void TaskGroup::join()
+{
+    // Once nothing is queued, every task of the group has started on some
+    // thread, so sleeping until the last one finishes cannot deadlock
+    while (outstanding.load(std::memory_order_acquire) > 0 && pool.runPendingTask()) {
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return outstanding.load(std::memory_order_acquire) == 0; });
+}
+
+void TaskGroup::wait()
+{
+    join();
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(thrown, error);
+    }
+    if (thrown) std::rethrow_exception(thrown);
+}
@@ -0,0 +1,87 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===============
+// ThreadPool
+// ===============
+// Work-stealing pool: each worker owns a deque, runs its own newest task
+// first (LIFO, cache-warm) and steals the oldest task from another worker
+// when it runs dry. Tasks submitted from inside a task go to the current
+// worker's deque, so a task can fan out sub-tasks cheaply.
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // threadCount 0 uses one worker per hardware thread.
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+    void submit(Task task);
+
+    // Runs one queued task on the calling thread. Returns false when no
+    // task was available, so waiting threads can help instead of idling.
+    bool runPendingTask();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popTask(unsigned self, Task& task);
+    void workerLoop(unsigned index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<unsigned> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+// ===============
+// TaskGroup
+// ===============
+// Tracks a batch of tasks on a pool. wait() returns once all of them have
+// finished, running queued work on the calling thread while there is any
+// and sleeping after that. A task that throws still counts as finished;
+// wait() rethrows the first such exception.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+    ~TaskGroup() { join(); } // an exception nobody waited for is dropped
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(ThreadPool::Task task);
+    void wait();
+
+private:
+    void join();
+    void finish();
+
+    ThreadPool& pool;
+    std::atomic<std::size_t> outstanding{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error; // first exception a task threw
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,38 @@
+#include "TokenStream.h"
+
+const char* tokenKindName(TokenKind kind)
+{
+    switch (kind) {
+    case TokenKind::Number:     return "Number";
+    case TokenKind::Identifier: return "Identifier";
+    case TokenKind::Keyword:    return "Keyword";
+    case TokenKind::Operator:   return "Operator";
+    case TokenKind::Delimiter:  return "Delimiter";
+    case TokenKind::Unknown:    return "Unknown";
+    }
+    return "Unknown";
+}
+
+bool tokenKindFromName(std::string_view name, TokenKind* kind)
+{
+    for (auto k : {TokenKind::Number, TokenKind::Identifier, TokenKind::Keyword, TokenKind::Operator,
+                   TokenKind::Delimiter, TokenKind::Unknown}) {
+        if (name == tokenKindName(k)) {
+            if (kind) *kind = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==========================
+//   TokenStream IMPLEMENTATION
+// ==========================
+
+TokenStream::TokenStream(std::shared_ptr<const void> owner, std::string_view source,
+                         std::vector<Token> tokens)
+    : sourceOwner(std::move(owner)),
+      sourceText(source),
+      tokenBuffer(std::make_shared<const std::vector<Token>>(std::move(tokens)))
+{
+}
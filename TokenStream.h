@@ -0,0 +1,66 @@
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ===============
+// Token
+// ===============
+enum class TokenKind : std::uint8_t {
+    Number,
+    Identifier,
+    Keyword,
+    Operator,
+    Delimiter,
+    Unknown
+};
+
+// Display name used by the token tables ("Number", "Identifier", ...)
+const char* tokenKindName(TokenKind kind);
+// The kind with that display name; false if there is none
+bool tokenKindFromName(std::string_view name, TokenKind* kind);
+
+// Compact token record; the text lives in the source buffer, so a
+// single stream covers sources of up to 4 GiB.
+struct Token {
+    std::uint32_t offset; // byte offset into the source
+    std::uint32_t length; // byte length
+    std::uint32_t line;   // 1-based
+    std::uint32_t column; // 1-based, counted in characters
+    TokenKind kind;
+};
+
+// ===============
+// TokenStream
+// ===============
+// Contiguous token buffer plus the source it points into. Copies are
+// cheap: both buffers are shared and immutable once built.
+class TokenStream
+{
+public:
+    TokenStream() = default;
+    TokenStream(std::shared_ptr<const void> owner, std::string_view source,
+                std::vector<Token> tokens);
+
+    std::string_view source() const { return sourceText; }
+    std::size_t size() const { return tokenBuffer ? tokenBuffer->size() : 0; }
+    bool empty() const { return size() == 0; }
+
+    const Token& operator[](std::size_t i) const { return (*tokenBuffer)[i]; }
+    const Token* begin() const { return tokenBuffer ? tokenBuffer->data() : nullptr; }
+    const Token* end() const { return begin() + size(); }
+
+    std::string_view text(const Token& t) const { return sourceText.substr(t.offset, t.length); }
+    std::string_view text(std::size_t i) const { return text((*this)[i]); }
+
+private:
+    std::shared_ptr<const void> sourceOwner; // keeps sourceText alive
+    std::string_view sourceText;
+    std::shared_ptr<const std::vector<Token>> tokenBuffer;
+};
+
+#endif // TOKENSTREAM_H
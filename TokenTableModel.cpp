@@ -0,0 +1,86 @@
+#include "TokenTableModel.h"
+
+TokenTableModel::TokenTableModel(const IncrementalLexer& lexer, QObject* parent)
+    : QAbstractTableModel(parent), lexer(lexer), rows(static_cast<int>(lexer.tokenCount()))
+{
+}
+
+void TokenTableModel::reload()
+{
+    beginResetModel();
+    rows = static_cast<int>(lexer.tokenCount());
+    endResetModel();
+}
+
+void TokenTableModel::applySplice(const TokenSplice& splice)
+{
+    // The rows that appear or disappear are taken from the end of the
+    // spliced range; everything from splice.first on is repainted below,
+    // since the lines after a multi-line edit shift as well.
+    const int first = static_cast<int>(splice.first);
+    const int removed = static_cast<int>(splice.removed);
+    const int inserted = static_cast<int>(splice.inserted);
+
+    if (inserted > removed) {
+        beginInsertRows(QModelIndex(), first + removed, first + inserted - 1);
+        rows += inserted - removed;
+        endInsertRows();
+    } else if (removed > inserted) {
+        beginRemoveRows(QModelIndex(), first + inserted, first + removed - 1);
+        rows -= removed - inserted;
+        endRemoveRows();
+    }
+
+    if (first < rowCount())
+        emit dataChanged(index(first, 0), index(rowCount() - 1, ColumnCount - 1));
+}
+
+QString TokenTableModel::tokenText(int row) const
+{
+    std::string_view text = lexer.text(row);
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+QString TokenTableModel::tokenType(int row) const
+{
+    return QString::fromLatin1(tokenKindName(lexer.token(row).kind));
+}
+
+int TokenTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : rows;
+}
+
+int TokenTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TokenTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    if (role != Qt::DisplayRole) return QVariant();
+
+    const Token tok = lexer.token(index.row());
+    switch (index.column()) {
+    case TokenColumn:  return tokenText(index.row());
+    case TypeColumn:   return tokenType(index.row());
+    case LineColumn:   return static_cast<uint>(tok.line);
+    case ColumnColumn: return static_cast<uint>(tok.column);
+    }
+    return QVariant();
+}
+
+QVariant TokenTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+    if (orientation == Qt::Vertical) return section + 1;
+
+    switch (section) {
+    case TokenColumn:  return QStringLiteral("Token");
+    case TypeColumn:   return QStringLiteral("Type");
+    case LineColumn:   return QStringLiteral("Line");
+    case ColumnColumn: return QStringLiteral("Column");
+    }
+    return QVariant();
+}
@@ -0,0 +1,43 @@
+#ifndef TOKENTABLEMODEL_H
+#define TOKENTABLEMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "IncrementalLexer.h"
+#include "TokenStream.h"
+
+// ===============
+// TokenTableModel
+// ===============
+// Read-only table over an IncrementalLexer's tokens. Cells are formatted on
+// demand, so a view only pays for the rows it actually paints.
+class TokenTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { TokenColumn, TypeColumn, LineColumn, ColumnColumn, ColumnCount };
+
+    explicit TokenTableModel(const IncrementalLexer& lexer, QObject* parent = nullptr);
+
+    // Call after the lexer was reset
+    void reload();
+    // Call after an incremental edit; keeps selection and scroll
+    void applySplice(const TokenSplice& splice);
+    // The current tokens as one stream, for the parser
+    TokenStream tokens() const { return lexer.tokens(); }
+
+    QString tokenText(int row) const;
+    QString tokenType(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    const IncrementalLexer& lexer;
+    int rows = 0; // the lexer's token count as announced to views
+};
+
+#endif // TOKENTABLEMODEL_H
@@ -0,0 +1,12 @@
+# Token classes of the Python subset, compiled into the scanner's DFA at
+# startup. One rule per line: token name, regex, priority. The longest
+# match wins; on equal length the higher priority, then the earlier line.
+# Names are the token kinds of the token table; any other name stops the
+# program when the scanner is first built. Whitespace and newlines are
+# skipped by the scanner itself, and identifiers that are keywords are
+# reclassified through Keywords.h.
+
+Number      [0-9]+(\.[0-9]+)?                   1
+Identifier  [A-Za-z_][A-Za-z0-9_]*              1
+Operator    [=<>+\-]=?|!=|\*[*=]?|/[/=]?|%      1
+Delimiter   [{}()\[\]:"']                       1
@@ -2,6 +2,7 @@
 #include "ProjectOverviewTab.h"
 #include "LexicalAnalysis.h"
 #include "SyntaxAnalysisTab.h"
+#include "ThompsonsBuilderTab.h"
 
 
 MainWindow::MainWindow(QWidget* parent)
@@ -13,13 +14,14 @@ MainWindow::MainWindow(QWidget* parent)
     overviewTab = new ProjectOverviewTab();
     lexicalTab = new LexicalAnalysisTab();
     syntaxTab = new SyntaxAnalysisTab();
+    thompsonTab = new ThompsonsBuilderTab();
 
-    connect(lexicalTab, &LexicalAnalysisTab::tokensReady,
-            syntaxTab, &SyntaxAnalysisTab::updateTokenTable);
+    syntaxTab->setTokenModel(lexicalTab->tokenModel());
 
     tabWidget->addTab(overviewTab, "Project Overview");
     tabWidget->addTab(lexicalTab, "Lexical Analysis");
     tabWidget->addTab(syntaxTab, "Syntax Analysis");
+    tabWidget->addTab(thompsonTab, "Thompson's Builder");
  
 
     tabWidget->setStyleSheet(R"(
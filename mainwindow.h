@@ -8,6 +8,7 @@
 class ProjectOverviewTab;
 class LexicalAnalysisTab;
 class SyntaxAnalysisTab;
+class ThompsonsBuilderTab;
 
 class MainWindow : public QMainWindow
 {
@@ -22,6 +23,7 @@ private:
     ProjectOverviewTab* overviewTab;
     LexicalAnalysisTab* lexicalTab;
     SyntaxAnalysisTab* syntaxTab;
+    ThompsonsBuilderTab* thompsonTab;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file